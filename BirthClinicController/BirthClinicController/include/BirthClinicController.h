@@ -6,15 +6,22 @@
 #include "Organism.h"
 #include "RoombotModule.h"
 #include "ParametersReader.h"
-#include "MessagesManager.h"
+#include "Message.h"
+#include "MessageView.h"
+#include "MessageDispatcher.h"
+#include "GenomeStore.h"
+#include "ChannelTraffic.h"
 #include "MindGenome.h"
 #include "Logger.h"
 #include "Random.h"
+#include "WebotsRadio.h"
 
 #include <webots/Supervisor.hpp>
 #include <stack>
 #include <limits>
 #include <deque>
+#include <memory>
+#include <algorithm>
 
 using namespace webots;
 
@@ -41,12 +48,15 @@ class BirthClinicController : public Supervisor
     int BIRTH_CLINIC_MINIMUM_MODULES = ParametersReader::get<bool>("BIRTH_CLINIC_MINIMUM_MODULES");
     
     unsigned int ROOMBOT_WAITING_TIME = ParametersReader::get<unsigned int>("ROOMBOT_WAITING_TIME");
+    double TRAFFIC_LOGGING_INTERVAL = ParametersReader::get<double>("TRAFFIC_LOGGING_INTERVAL");
+    int GENOME_STORE_SIZE = std::max(0, ParametersReader::get<int>("GENOME_STORE_SIZE"));
     
     
     Node * platform;
     
-    Receiver * receiver;
-    Emitter * emitter;
+    // radio devices, seen through the interfaces of Radio.h like the ones of the organisms
+    std::unique_ptr<RadioReceiver> receiver;
+    std::unique_ptr<RadioEmitter> emitter;
     
     Position position = Position(0,5,0,true);
     
@@ -57,7 +67,13 @@ class BirthClinicController : public Supervisor
     
     id_t nextOrganismId;
     
-    std::deque<std::string> buildQueue;
+    std::deque<Message> buildQueue;
+    
+    MessageDispatcher messageDispatcher;
+    
+    GenomeStore genomeStore;
+    
+    ChannelTraffic traffic;
     
     void connectModulesToObjects();
     
@@ -73,9 +89,9 @@ class BirthClinicController : public Supervisor
     
 	Position getFreeRandomPosition(double size);
         
-    void readGenomeMessage(std::string message, std::string * genomeStr, std::string * mindStr, id_t * parent1, id_t * parent2, std::string * fitness1, std::string * fitness2);
+    void readGenomeMessage(const Message & message, std::string * genomeStr, std::string * mindStr, id_t * parent1, id_t * parent2, std::string * fitness1, std::string * fitness2);
     
-    void readRebuildMessage(std::string message, id_t * organismId, std::string * genomeStr, std::string * mindStr);
+    bool readRebuildMessage(const MessageView & message, id_t * organismId, std::string * genomeStr, std::string * mindStr);
     
     void addModuleToReserve(std::string moduleDef);
        
@@ -91,9 +107,9 @@ class BirthClinicController : public Supervisor
     
     void sendOrganismBuiltMessage(id_t parent1, id_t parent2, id_t organism, unsigned int size, std::string genome, std::string mind);
     
-    bool rebuildOrganism(std::string message, int &buildTry);
+    bool rebuildOrganism(const MessageView & message, int &buildTry);
     
-    bool buildOrganismFromMessage(std::string message, int &buildTry);
+    bool buildOrganismFromMessage(const Message & message, int &buildTry);
 
     public:
     
@@ -96,12 +96,12 @@ Position BirthClinicController::getFreeRandomPosition(double size)
 
 void BirthClinicController::addModuleToReserve(std::string moduleDef)
 {
-    Node * root = getFromDef(moduleDef);
-    if (root)
+    // modules were connected to their nodes at startup, no need to look the DEF up again
+    unsigned int idx = std::atoi(moduleDef.substr(moduleDef.find("_")+1, moduleDef.length()).c_str());
+    std::map<unsigned int, Module *>::iterator module = moduleMap.find(idx);
+    if (module != moduleMap.end())
     {
-        unsigned int idx = std::atoi(moduleDef.substr(moduleDef.find("_")+1, moduleDef.length()).c_str());
-        
-        moduleMap[idx]->toReserve();
+        module->second->toReserve();
         
         bool alreadyAvailable = false;
         std::stack<id_t> stackCopy = availableModules;
@@ -128,31 +128,36 @@ void BirthClinicController::addModuleToReserve(std::string moduleDef)
 }
 
 
-void BirthClinicController::readGenomeMessage(std::string message, std::string * genomeStr, std::string * mindStr, id_t * parent1, id_t * parent2, std::string * fitness1, std::string * fitness2)
+void BirthClinicController::readGenomeMessage(const Message & message, std::string * genomeStr, std::string * mindStr, id_t * parent1, id_t * parent2, std::string * fitness1, std::string * fitness2)
 {
     // Template:
     // GENOME<genome data>MIND<mind data>PARENTSparent1-parent2PARENTS_FITNESSfitness1-fitness2
     
-    *genomeStr = MessagesManager::get(message, "GENOME");
-    *mindStr = MessagesManager::get(message, "MIND");
+    *genomeStr = message.get("GENOME");
+    *mindStr = message.get("MIND");
     
-    std::string parentsSubStr = MessagesManager::get(message, "PARENTS");
-    *parent1 = std::atoi(parentsSubStr.substr(0, parentsSubStr.find("-")).c_str());
-    *parent2 = std::atoi(parentsSubStr.substr(parentsSubStr.find("-")+1, parentsSubStr.length()).c_str());
+    boost::string_ref parentsSubStr = message.getView("PARENTS");
+    *parent1 = std::atoi(parentsSubStr.substr(0, parentsSubStr.find('-')).to_string().c_str());
+    *parent2 = std::atoi(parentsSubStr.substr(parentsSubStr.find('-')+1).to_string().c_str());
     
-    std::string fitnessSubStr = MessagesManager::get(message, "PARENTS_FITNESS");
-    *fitness1 = fitnessSubStr.substr(0, fitnessSubStr.find("-")).c_str();
-    *fitness2 = fitnessSubStr.substr(fitnessSubStr.find("-")+1, fitnessSubStr.length()).c_str();
+    boost::string_ref fitnessSubStr = message.getView("PARENTS_FITNESS");
+    *fitness1 = fitnessSubStr.substr(0, fitnessSubStr.find('-')).to_string();
+    *fitness2 = fitnessSubStr.substr(fitnessSubStr.find('-')+1).to_string();
 }
 
 
-void BirthClinicController::readRebuildMessage(std::string message, id_t * organismId, std::string * genomeStr, std::string * mindStr)
+bool BirthClinicController::readRebuildMessage(const MessageView & message, id_t * organismId, std::string * genomeStr, std::string * mindStr)
 {
     // Template:
-    // <organismId>GENOME<genome-data>MIND<mind-data>
-    *organismId = std::atoi(MessagesManager::get(message, "ID").c_str());
-    *genomeStr = MessagesManager::get(message, "GENOME");
-    *mindStr = MessagesManager::get(message, "MIND");
+    // <organismId>GENOME_DIGEST<digest>[GENOME<genome-data>]MIND_DIGEST<digest>[MIND<mind-data>]
+    *organismId = message.getLong("ID");
+    std::string missingDigest;
+    if (!genomeStore.resolve(message, "GENOME", genomeStr, &missingDigest) || !genomeStore.resolve(message, "MIND", mindStr, &missingDigest))
+    {
+        logger.warnStream() << "Cannot rebuild organism " << *organismId << ", unknown genome " << missingDigest;
+        return false;
+    }
+    return true;
 }
 
 
@@ -193,22 +198,27 @@ void BirthClinicController::rotate()
 
 void BirthClinicController::sendOrganismBuiltMessage(id_t parent1, id_t parent2, id_t organism, unsigned int size, std::string genome, std::string mind)
 {
-    std::string orgbuilt = "[ORGANISM_BUILT_MESSAGE]";
-    orgbuilt = MessagesManager::add(orgbuilt, "ORGANISM_ID", std::to_string(organism));
+    Message orgbuilt(ORGANISM_BUILT_MESSAGE);
+    orgbuilt.add("ORGANISM_ID", std::to_string(organism));
     
     // Let the screenshot controller know to make a screenshot
+    std::string data = orgbuilt.encode();
     emitter->setChannel(SCREENSHOT_CHANNEL);
-    emitter->send(orgbuilt.c_str(), (int)orgbuilt.length()+1);
+    emitter->send(data.data(), (int)data.size());
+    traffic.countSent(SCREENSHOT_CHANNEL, data.size());
     
     
-    orgbuilt = MessagesManager::add(orgbuilt, "PARENT1", std::to_string(parent1));
-    orgbuilt = MessagesManager::add(orgbuilt, "PARENT2", std::to_string(parent2));
-    orgbuilt = MessagesManager::add(orgbuilt, "SIZE", std::to_string(size));
-    orgbuilt = MessagesManager::add(orgbuilt, "GENOME", genome);
-    orgbuilt = MessagesManager::add(orgbuilt, "MIND", mind);
+    orgbuilt.add("PARENT1", std::to_string(parent1));
+    orgbuilt.add("PARENT2", std::to_string(parent2));
+    orgbuilt.add("SIZE", std::to_string(size));
+    // the evolver created both genomes, but may have dropped them from its store while they were queued
+    genomeStore.addFull(orgbuilt, "GENOME", genome);
+    genomeStore.addFull(orgbuilt, "MIND", mind);
     
+    data = orgbuilt.encode();
     emitter->setChannel(EVOLVER_CHANNEL);
-    emitter->send(orgbuilt.c_str(), (int)orgbuilt.length()+1);
+    emitter->send(data.data(), (int)data.size());
+    traffic.countSent(EVOLVER_CHANNEL, data.size());
 }
 
 ////////////////////////////////////////////
@@ -334,7 +344,8 @@ void BirthClinicController::logModuleCount(std::string message, int modules)
 ////////////////////////////////////////////
 
 BirthClinicController::BirthClinicController() : Supervisor(),
-    logger(Logger::getInstance("BirthClinic"))
+    logger(Logger::getInstance("BirthClinic")),
+    genomeStore(GENOME_STORE_SIZE)
 {
     logger.debug("Constructing Birth Clinic Controller");
     
@@ -342,9 +353,11 @@ BirthClinicController::BirthClinicController() : Supervisor(),
     
     platform = getFromDef("CLINIC_PLATFORM");
     
-    receiver = getReceiver(RECEIVER_NAME);
+    Receiver * receiverDevice = getReceiver(RECEIVER_NAME);
+    receiverDevice->enable(getBasicTimeStep());
+    receiver.reset(new WebotsReceiver(receiverDevice));
     receiver->setChannel(CLINIC_CHANNEL);
-    emitter = getEmitter(EMITTER_NAME);
+    emitter.reset(new WebotsEmitter(getEmitter(EMITTER_NAME)));
     
     // setup builder for shape encoding
     if (SHAPE_ENCODING == "CPPN")
@@ -369,11 +382,14 @@ BirthClinicController::~BirthClinicController()
 /********************************
  ******* REBUILD ORGANISM *******
  ********************************/
-bool BirthClinicController::rebuildOrganism(std::string message, int &buildTry) {
+bool BirthClinicController::rebuildOrganism(const MessageView & message, int &buildTry) {
     id_t organismId;
     std::string genomeStr;
     std::string mindStr;
-    readRebuildMessage(message, &organismId, &genomeStr, &mindStr);
+    if (!readRebuildMessage(message, &organismId, &genomeStr, &mindStr))
+    {
+        return true;
+    }
     
     double time = getTime();
     while (getTime() - time < 3)
@@ -403,7 +419,7 @@ bool BirthClinicController::rebuildOrganism(std::string message, int &buildTry)
 /**********************************
  ******* BUILD NEW ORGANISM *******
  **********************************/
-bool BirthClinicController::buildOrganismFromMessage(std::string message, int &buildTry) {
+bool BirthClinicController::buildOrganismFromMessage(const Message & message, int &buildTry) {
     std::string genomeStr;
     std::string mindStr;
     id_t parent1, parent2;
@@ -446,7 +462,6 @@ void BirthClinicController::run()
     
     TIME_STEP = getBasicTimeStep();
 
-    receiver->enable(TIME_STEP);
     while (receiver->getQueueLength() > 0)
     {
         receiver->nextPacket();
@@ -464,11 +479,11 @@ void BirthClinicController::run()
     {
         if(receiver->getQueueLength() > 0)
         {
-            std::string message = (char*)receiver->getData();
-            if (message.substr(0,24).compare("[ENVIRONMENT_OK_MESSAGE]") == 0)
+            Message message = Message::decode(receiver->getData(), receiver->getDataSize());
+            if (message.getType() == ENVIRONMENT_OK_MESSAGE)
             {
                 environmentOk = true;
-                simulationDateAndTime = MessagesManager::get(message, "SDAT");
+                simulationDateAndTime = message.get("SDAT");
                 logger.debug("Environment ready");
             }
             receiver->nextPacket();
@@ -483,6 +498,46 @@ void BirthClinicController::run()
     
     int buildTry = 0;
     int waitTime = -5;
+    double lastTrafficLogging = 0;
+    
+    messageDispatcher.registerHandler(UPDATE_AVAILABLE_MESSAGE, [this](const MessageView & message) {
+        logger.debug("Received available message");
+        std::string moduleDef = message.get("DEF").to_string();
+        addModuleToReserve(moduleDef);
+        return true;
+    });
+    messageDispatcher.registerHandler(REBUILD_MESSAGE, [this, &buildTry](const MessageView & message) {
+        logger.debug("Received rebuild message");
+        return rebuildOrganism(message, buildTry);
+    });
+    messageDispatcher.registerHandler(GENOME_TO_CLINIC_MESSAGE, [this](const MessageView & message) {
+        logger.debug("Received genome to clinic message");
+        // Remember the genomes, while recently used
+        std::string genome;
+        std::string mind;
+        std::string missingDigest;
+        if (!genomeStore.resolve(message, "GENOME", &genome, &missingDigest) || !genomeStore.resolve(message, "MIND", &mind, &missingDigest))
+        {
+            logger.warnStream() << "Cannot build offspring of " << message.get("PARENTS") << ", unknown genome " << missingDigest;
+            return true;
+        }
+        // Add to queue, with the genomes in full as readGenomeMessage expects them
+        Message queued(message);
+        if (!message.has("GENOME"))
+        {
+            queued.add("GENOME", genome);
+        }
+        if (!message.has("MIND"))
+        {
+            queued.add("MIND", mind);
+        }
+        buildQueue.push_back(queued);
+        if(BIRTH_CLINIC_USE_QUEUE) {
+            logger.noticeStream() << BOLDRED << " Adding genome to queue, queue is now: " << buildQueue.size() << RESET;
+        }
+        return true;
+    });
+    
     while (step(TIME_STEP) != -1)
     {
         /*******************************
@@ -490,36 +545,25 @@ void BirthClinicController::run()
          *******************************/
         double now = getTime();
         
+        traffic.countQueueLength(CLINIC_CHANNEL, receiver->getQueueLength());
         while (receiver->getQueueLength() > 0) {
-            std::string message = (char*)receiver->getData();
-            bool goNext = true;
-            
-            if (message.substr(0,26).compare("[UPDATE_AVAILABLE_MESSAGE]") == 0) {
-                logger.debug("Received available message");
-                std::string moduleDef = MessagesManager::get(message, "DEF");
-                addModuleToReserve(moduleDef);
-            } else if (message.substr(0,17).compare("[REBUILD_MESSAGE]") == 0) {
-                logger.debug("Received rebuild message");
-                goNext = rebuildOrganism(message, buildTry);
-            } else if (message.substr(0,26).compare("[GENOME_TO_CLINIC_MESSAGE]") == 0) {
-                logger.debug("Received genome to clinic message");
-                    // Add to queue
-                buildQueue.push_back(message);
-                if(BIRTH_CLINIC_USE_QUEUE) {
-                    logger.noticeStream() << BOLDRED << " Adding genome to queue, queue is now: " << buildQueue.size() << RESET;
-                }
-            } else {
-                // Not enough modules in store, go to next shape
-            }
+            MessageView message(receiver->getData(), receiver->getDataSize());
+            bool goNext = messageDispatcher.dispatch(message);
             
             if(goNext) {
+                traffic.countReceived(CLINIC_CHANNEL, receiver->getDataSize());
                 receiver->nextPacket();
             }
         }
+        
+        if(now - lastTrafficLogging > TRAFFIC_LOGGING_INTERVAL) {
+            traffic.store(RESULTS_PATH + simulationDateAndTime + "/traffic.txt", "clinic", now);
+            lastTrafficLogging = now;
+        }
 
         if(now > waitTime + ROOMBOT_WAITING_TIME) {
             if(buildQueue.size() > 0 && availableModules.size() > BIRTH_CLINIC_MINIMUM_MODULES){
-                std::string message = buildQueue.front();
+                Message message = buildQueue.front();
                 bool success = buildOrganismFromMessage(message,buildTry);
                 if(success){
                     buildQueue.pop_front();
@@ -4,7 +4,9 @@
 #include "Defines.h"
 #include "Position.h"
 #include "ParametersReader.h"
-#include "MessagesManager.h"
+#include "Message.h"
+#include "MessageView.h"
+#include "MessageDispatcher.h"
 
 #include <webots/Supervisor.hpp>
 #include <boost/filesystem.hpp>
@@ -36,8 +38,29 @@ private:
     Receiver * receiver;
     Emitter * emitter;
     
+    MessageDispatcher messageDispatcher;
+    
     std::string simulationDateAndTime;
     
+    /**
+     * Fields of a module that the modifier changes, resolved once at startup
+     * instead of looking the module up by its DEF every time it goes to the reserve.
+     */
+    struct ModuleFields
+    {
+        Node * root = NULL;
+        Field * name = NULL;
+        Field * controller = NULL;
+        Field * translation = NULL;
+        Field * rotation = NULL;
+        std::vector<Field *> connectorLocks;
+    };
+    
+    // by module id; modules missing from the world have no root
+    std::vector<ModuleFields> modules;
+    
+    
+    void connectModules();
     
     void putAllModulesToReserve();
     
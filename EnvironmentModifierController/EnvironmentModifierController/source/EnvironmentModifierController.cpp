@@ -2,28 +2,54 @@
 
 
 
-void EnvironmentModifierController::putAllModulesToReserve()
+static const char * CONNECTOR_LOCKS[] = {
+    "CB1XLocked", "CB1YLocked", "CB1ZLocked", "CW1XLocked", "CW1ZLocked",
+    "CB2XLocked", "CB2ZLocked", "CW2XLocked", "CW2YLocked", "CW2ZLocked"
+};
+
+
+void EnvironmentModifierController::connectModules()
 {
-    // connect real modules to objects and store them into map and stack
+    modules.assign(NUMBER_OF_MODULES + 1, ModuleFields());
     for (id_t i = 1; i <= NUMBER_OF_MODULES; i++)
     {
         Node * root = getFromDef(MODULE_DEF_BASE_NAME + std::to_string(i));
         if (root)
         {
-            Field * translation = root->getField("translation");
-            Field * rotation = root->getField("rotation");
-            
+            ModuleFields & module = modules[i];
+            module.root = root;
+            module.name = root->getField("name");
+            module.controller = root->getField("controller");
+            module.translation = root->getField("translation");
+            module.rotation = root->getField("rotation");
+            for (size_t j = 0; j < sizeof(CONNECTOR_LOCKS) / sizeof(CONNECTOR_LOCKS[0]); j++)
+            {
+                module.connectorLocks.push_back(root->getField(CONNECTOR_LOCKS[j]));
+            }
+        }
+        else
+        {
+            std::cout << MODULE_DEF_BASE_NAME + std::to_string(i) + " does not exist." << std::endl;
+        }
+    }
+}
+
+
+void EnvironmentModifierController::putAllModulesToReserve()
+{
+    // connect real modules to objects and store them into map and stack
+    for (id_t i = 1; i < modules.size(); i++)
+    {
+        ModuleFields & module = modules[i];
+        if (module.root)
+        {
             Position position = Position(
                                  (ARENA_SIZE/2) + SPARE_DISTANCE,
                                  GROUND_HEIGHT,
                                  i);
             
-            translation->setSFVec3f(position.getTransaltion());
-            rotation->setSFRotation(position.getRotation());
-        }
-        else
-        {
-            std::cout << MODULE_DEF_BASE_NAME + std::to_string(i) + " does not exist." << std::endl;
+            module.translation->setSFVec3f(position.getTransaltion());
+            module.rotation->setSFRotation(position.getRotation());
         }
     }
 }
@@ -31,89 +57,65 @@ void EnvironmentModifierController::putAllModulesToReserve()
 
 void EnvironmentModifierController::putModuleToReserve(std::string moduleName)
 {
-    for (int i = 1; i <= NUMBER_OF_MODULES; i++)
+    std::string toRemoveSubStr = moduleName.substr(0,moduleName.find(":"));
+    for (id_t i = 1; i < modules.size(); i++)
     {
-        Node * root = getFromDef(MODULE_DEF_BASE_NAME + std::to_string(i));
-        if (root)
+        ModuleFields & module = modules[i];
+        if (module.root)
         {
-            Field * name = root->getField("name");
-            
-            std::string toRemoveSubStr = moduleName.substr(0,moduleName.find(":"));
-            std::string toCheckSubStr = name->getSFString().substr(0,name->getSFString().find(":"));
+            std::string name = module.name->getSFString();
+            std::string toCheckSubStr = name.substr(0,name.find(":"));
             
             if (toRemoveSubStr.compare(toCheckSubStr) == 0)
             {
-                Field * controller = root->getField("controller");
-                controller->setSFString("void");
+                module.controller->setSFString("void");
                 
                 //Field * controllerArgs = root->getField("controllerArgs");
                 //controllerArgs->setSFString("");
                 
-                Field * CB1XLocked = root->getField("CB1XLocked");
-                Field * CB1YLocked = root->getField("CB1YLocked");
-                Field * CB1ZLocked = root->getField("CB1ZLocked");
-                Field * CW1XLocked = root->getField("CW1XLocked");
-                Field * CW1ZLocked = root->getField("CW1ZLocked");
-                Field * CB2XLocked = root->getField("CB2XLocked");
-                Field * CB2ZLocked = root->getField("CB2ZLocked");
-                Field * CW2XLocked = root->getField("CW2XLocked");
-                Field * CW2YLocked = root->getField("CW2YLocked");
-                Field * CW2ZLocked = root->getField("CW2ZLocked");
-                
-                CB1XLocked->setSFBool(false);
-                CB1YLocked->setSFBool(false);
-                CB1ZLocked->setSFBool(false);
-                CW1XLocked->setSFBool(false);
-                CW1ZLocked->setSFBool(false);
-                CB2XLocked->setSFBool(false);
-                CB2ZLocked->setSFBool(false);
-                CW2XLocked->setSFBool(false);
-                CW2YLocked->setSFBool(false);
-                CW2ZLocked->setSFBool(false);
-                
-                Field * translation = root->getField("translation");
-                Field * rotation = root->getField("rotation");
+                for (size_t j = 0; j < module.connectorLocks.size(); j++)
+                {
+                    module.connectorLocks[j]->setSFBool(false);
+                }
                 
                 Position position = Position(
                                              (ARENA_SIZE/2) + SPARE_DISTANCE,
                                              GROUND_HEIGHT,
                                              i);
                 
-                translation->setSFVec3f(position.getTransaltion());
-                rotation->setSFRotation(position.getRotation());
+                module.translation->setSFVec3f(position.getTransaltion());
+                module.rotation->setSFRotation(position.getRotation());
                 
                 std::cout << moduleName << " to reserve" << std::endl;
                 
                 sendUpdateAvailableMessageToBirthClinic(MODULE_DEF_BASE_NAME + std::to_string(i));
             }
         }
-        else
-        {
-            std::cout << MODULE_DEF_BASE_NAME + std::to_string(i) + " does not exist." << std::endl;
-        }
     }
 }
 
 
 void EnvironmentModifierController::sendInitializedEnvironmentMessage()
 {
-    std::string message = "[ENVIRONMENT_OK_MESSAGE]";
-    message = MessagesManager::add(message, "SDAT", simulationDateAndTime);
+    Message message(ENVIRONMENT_OK_MESSAGE);
+    message.add("SDAT", simulationDateAndTime);
+    std::string data = message.encode();
     emitter->setChannel(EVOLVER_CHANNEL);
-    emitter->send(message.c_str(), (int)message.length()+1);
+    emitter->send(data.data(), (int)data.size());
     emitter->setChannel(CLINIC_CHANNEL);
-    emitter->send(message.c_str(), (int)message.length()+1);
+    emitter->send(data.data(), (int)data.size());
     emitter->setChannel(SCREENSHOT_CHANNEL);
-    emitter->send(message.c_str(), (int)message.length()+1);
+    emitter->send(data.data(), (int)data.size());
 }
 
 
 void EnvironmentModifierController::sendUpdateAvailableMessageToBirthClinic(std::string moduleDef)
 {
     emitter->setChannel(CLINIC_CHANNEL);
-    std::string message = "[UPDATE_AVAILABLE_MESSAGE]";
-    message = MessagesManager::add(message, "DEF", moduleDef);
-    emitter->send(message.c_str(), (int)message.length()+1);
+    Message message(UPDATE_AVAILABLE_MESSAGE);
+    message.add("DEF", moduleDef);
+    std::string data = message.encode();
+    emitter->send(data.data(), (int)data.size());
 }
 
 
@@ -169,21 +171,23 @@ void EnvironmentModifierController::run()
         receiver->nextPacket();
     }
     
+    connectModules();
     putAllModulesToReserve();
     
     sendInitializedEnvironmentMessage();
     
+    messageDispatcher.registerHandler(TO_RESERVE_MESSAGE, [this](const MessageView & message) {
+        std::string moduleName = message.get("NAME").to_string();
+        putModuleToReserve(moduleName);
+        return true;
+    });
+    
     while (step(TIME_STEP) != -1)
     {
         while(receiver->getQueueLength() > 0)
         {
-            std::string message = (char*)receiver->getData();
-            
-            if (message.substr(0,20).compare("[TO_RESERVE_MESSAGE]") == 0)
-            {
-                std::string moduleName = MessagesManager::get(message, "NAME");
-                putModuleToReserve(moduleName);
-            }
+            MessageView message(receiver->getData(), receiver->getDataSize());
+            messageDispatcher.dispatch(message);
             
             receiver->nextPacket();
         }
@@ -4,16 +4,28 @@
 #include "GenomeManager.h"
 #include "CppnGenomeManager.h"
 #include "ParametersReader.h"
-#include "MessagesManager.h"
+#include "Message.h"
+#include "MessageView.h"
+#include "MessageDispatcher.h"
+#include "GenomeStore.h"
+#include "LruCache.h"
+#include "WorkerPool.h"
+#include "ChannelTraffic.h"
+#include "EventJournal.h"
 #include "MatrixGenomeManager.h"
 #include "Organism.h"
+#include "OrganismRegistry.h"
+#include "OrganismsHistory.h"
 #include "ParentSelectionMechanism.h"
 #include "Builder.h"
 #include "Random.h"
 #include "Logger.h"
+#include "WebotsRadio.h"
 
 #include <webots/Supervisor.hpp>
 
+#include <algorithm>
+
 
 using namespace webots;
 
@@ -34,6 +46,16 @@ private:
     int MATING_TIME = ParametersReader::get<int>("MATING_TIME");
     int DYING_TIME = ParametersReader::get<int>("DYING_TIME");
     int CHECK_EVOLUTION_END_INTERVAL = ParametersReader::get<int>("CHECK_EVOLUTION_END_INTERVAL");
+    double TRAFFIC_LOGGING_INTERVAL = ParametersReader::get<double>("TRAFFIC_LOGGING_INTERVAL");
+    int PARSED_GENOME_CACHE_SIZE = ParametersReader::get<int>("PARSED_GENOME_CACHE_SIZE");
+    int GENOME_STORE_SIZE = std::max(0, ParametersReader::get<int>("GENOME_STORE_SIZE"));
+    // candidates per batch below 1 would never finish creating offspring, and negative workers make a huge unsigned thread count
+    int OFFSPRING_WORKERS = std::max(0, ParametersReader::get<int>("OFFSPRING_WORKERS"));
+    int OFFSPRING_CANDIDATES = std::max(1, ParametersReader::get<int>("OFFSPRING_CANDIDATES"));
+    int JOURNAL_BUFFER_SIZE = ParametersReader::get<int>("JOURNAL_BUFFER_SIZE");
+    double JOURNAL_FLUSH_INTERVAL = ParametersReader::get<double>("JOURNAL_FLUSH_INTERVAL");
+    
+    static const int MAXIMUM_OFFSPRING_CANDIDATES = 100;
     
     int WAITING_INTERVAL_GENOMES_INITIALIZATION = ParametersReader::get<int>("WAITING_INTERVAL_GENOMES_INITIALIZATION");
     int NOISE_GENOMES_INITIALIZATION = ParametersReader::get<int>("NOISE_GENOMES_INITIALIZATION");
@@ -48,8 +70,9 @@ private:
     MatingType matingType;
     DeathType deathType;
     
-    Receiver * receiver; 
-    Emitter * emitter;
+    // radio devices, seen through the interfaces of Radio.h like the ones of the organisms
+    std::unique_ptr<RadioReceiver> receiver;
+    std::unique_ptr<RadioEmitter> emitter;
     
     Builder * builder;
     
@@ -57,7 +80,26 @@ private:
     MindGenomeManager * mindGenomeManager;
     ParentSelectionMechanism * parentSelectionMechanism;
     
-    std::vector<Organism> organismsList;
+    MessageDispatcher messageDispatcher;
+    
+    GenomeStore genomeStore;
+    
+    // parsed parents genomes, by digest of their text, since the same parents mate many times
+    LruCache<std::string, CppnGenome> parsedGenomes;
+    LruCache<std::string, boost::shared_ptr<MindGenome> > parsedMinds;
+    
+    // screen the build plans of offspring candidates
+    WorkerPool offspringWorkers;
+    
+    ChannelTraffic traffic;
+    
+    OrganismRegistry organismsList;
+    
+    // controller field of every module, by module id, resolved once at startup; NULL for missing modules
+    std::vector<Field *> moduleControllers;
+    
+    // results files, appended by a background writer
+    EventJournal journal;
 
         
     std::vector<id_t> selectForMating();
@@ -77,20 +119,45 @@ private:
     double lastDeath;       // FOR CENTRALIZED DEATH BY THE EVOLVER
     double lastEvolutionEndCheck;
     double lastOffspringLoggingTime;
+    double lastTrafficLogging;
     
     Utils::Random *random;
     
     /*************************
      ******* Functions *******
      *************************/
+    void connectModules();
+    
     bool checkEvolutionEnd();
     
-    void readFitnessMessage(id_t * id, double * fitness, std::string * genome, std::string * mind, std::string message);
+    bool readFitnessMessage(id_t * id, double * fitness, std::string * genome, std::string * mind, const MessageView & message);
     
-    void readCoupleMessage(std::string message, id_t * id1, double * fitness1, std::string * genome1, std::string * mind1, id_t * id2, double * fitness2, std::string * genome2, std::string * mind2);
+    /**
+     * @param digests Set to the digests the genomes are stored under, GENOME1, MIND1, GENOME2 and MIND2 in this order.
+     */
+    bool readCoupleMessage(const MessageView & message, id_t * id1, double * fitness1, std::string * genome1, std::string * mind1, id_t * id2, double * fitness2, std::string * genome2, std::string * mind2, std::string digests[4]);
     
     CppnGenome createRandomGenome();
     
+    /**
+     * Creates offspring of the parents until one has a non-empty build plan, trying at most
+     * MAXIMUM_OFFSPRING_CANDIDATES. Candidates are created in batches of OFFSPRING_CANDIDATES
+     * and their plans are built in parallel; the first candidate of a batch with a non-empty plan is
+     * chosen, so the result only depends on the random seed, not on the number of workers.
+     *
+     * @return The offspring, or an empty pointer if every candidate had an empty plan.
+     */
+    std::unique_ptr<CppnGenome> createOffspring(const std::vector<CppnGenome> & parentsGenomes);
+    
+    /**
+     * Parses a body genome, unless it is in the cache of parsed genomes.
+     *
+     * @param digest The digest of the genome text.
+     */
+    CppnGenome parseGenome(const std::string & digest, const std::string & genome);
+    
+    boost::shared_ptr<MindGenome> parseMind(const std::string & digest, const std::string & mind);
+    
     void sendGenomeToBirthClinic(std::string genome, std::string newMind, id_t parent1, id_t parent2, double fitness1, double fitness2);
     
     void sendDeathMessage(id_t organimsId);
@@ -110,24 +177,43 @@ private:
     
     void storePopulationSizesOnFile(double currentTime);
     
+    /**
+     * Appends the statistics of the organism registry to population_statistics.txt,
+     * leaving the format of populations.txt as it was.
+     */
+    void storePopulationStatisticsOnFile(double currentTime);
+    
     void logListProblem(std::string event, std::string message, std::string fields);
     
+    /**
+     * @return The ids of the organisms in the list, in list order, each preceded by a space.
+     */
+    std::string getOrganismIdsAsString();
+    
+    /**
+     * Appends a change of the organisms list to organisms_delta.txt, from which
+     * the list at any time can be rebuilt with OrganismsSnapshot.
+     */
+    void storeOrganismsChange(OrganismRegistry::Change change, const Organism & organism);
+    
     /*************************
      **** MessageHandlers ****
      *************************/
-    void deathMessage(std::string message, double currentTime);
+    void deathMessage(const MessageView & message, double currentTime);
     
-    void birthMessage(std::string message, double currentTime);
+    void birthMessage(const MessageView & message, double currentTime);
     
-    void adultMessage(std::string message, double currentTime);
+    void adultMessage(const MessageView & message, double currentTime);
     
-    void fertileMessage(std::string message, double currentTime);
+    void fertileMessage(const MessageView & message, double currentTime);
     
-    void fitnessUpdateMessage(std::string message, double currentTime);
+    void fitnessUpdateMessage(const MessageView & message, double currentTime);
     
-    void coupleMessage(std::string message,double currentTime);
+    void coupleMessage(const MessageView & message, double currentTime);
     
-    void genomeSpreadMessage(std::string message, double currentTime);
+    void genomeSpreadMessage(const MessageView & message, double currentTime);
+    
+    void registerMessageHandlers();
 
     /*************************
      ******* Utility *********
@@ -136,8 +222,6 @@ private:
     
     bool checkEmptyPlan(CppnGenome genome);
     
-    std::string getOrganismsListAsString();
-    
 public:
     
     EvolverController();
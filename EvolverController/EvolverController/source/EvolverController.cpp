@@ -1,3 +1,4 @@
+#include <sstream>
 #include <utility>
 
 #include "EvolverController.h"
@@ -8,15 +9,28 @@
 
 
 
-bool EvolverController::checkEvolutionEnd()
+void EvolverController::connectModules()
 {
+    moduleControllers.assign(NUMBER_OF_MODULES + 1, NULL);
     for (id_t i = 1; i <= NUMBER_OF_MODULES; i++)
     {
         Node * root = getFromDef(MODULE_DEF_BASE_NAME + std::to_string(i));
         if (root)
         {
-            Field * controller = root->getField("controller");
-            if (controller->getSFString().compare("void") != 0 && controller->getSFString().compare("DeathController"))
+            moduleControllers[i] = root->getField("controller");
+        }
+    }
+}
+
+
+bool EvolverController::checkEvolutionEnd()
+{
+    for (id_t i = 1; i < moduleControllers.size(); i++)
+    {
+        if (moduleControllers[i])
+        {
+            std::string controller = moduleControllers[i]->getSFString();
+            if (controller.compare("void") != 0 && controller.compare("DeathController"))
             {
                 return false;
             }
@@ -28,27 +42,76 @@ bool EvolverController::checkEvolutionEnd()
 
 CppnGenome EvolverController::createRandomGenome()
 {
-    for (int i = 0; i < 100; i++)
+    std::unique_ptr<CppnGenome> newGenome = createOffspring(std::vector<CppnGenome>());
+    if (newGenome)
     {
-        CppnGenome newGenome = genomeManager->createGenome(std::vector<CppnGenome>());
-        bool empty = checkEmptyPlan(newGenome);
-        if (!empty)
+        return *newGenome;
+    }
+    return genomeManager->createGenome(std::vector<CppnGenome>());;
+}
+
+
+std::unique_ptr<CppnGenome> EvolverController::createOffspring(const std::vector<CppnGenome> & parentsGenomes)
+{
+    for (int created = 0; created < MAXIMUM_OFFSPRING_CANDIDATES; created += OFFSPRING_CANDIDATES)
+    {
+        // candidates are created on this thread, always in the same order, since genome
+        // operators draw from the NEAT global random generator
+        std::vector<CppnGenome> candidates;
+        int batchSize = std::min(OFFSPRING_CANDIDATES, MAXIMUM_OFFSPRING_CANDIDATES - created);
+        for (int i = 0; i < batchSize; i++)
+        {
+            candidates.push_back(genomeManager->createGenome(parentsGenomes));
+        }
+        
+        std::vector<char> empty(candidates.size());
+        offspringWorkers.run(candidates.size(), [this, &candidates, &empty](size_t i) {
+            empty[i] = checkEmptyPlan(candidates[i]);
+        });
+        
+        for (size_t i = 0; i < candidates.size(); i++)
         {
-            return newGenome;
+            if (!empty[i])
+            {
+                return std::unique_ptr<CppnGenome>(new CppnGenome(candidates[i]));
+            }
         }
     }
-    return genomeManager->createGenome(std::vector<CppnGenome>());;
+    return std::unique_ptr<CppnGenome>();
 }
 
 
-bool EvolverController::checkEmptyPlan(CppnGenome genome)
+CppnGenome EvolverController::parseGenome(const std::string & digest, const std::string & genome)
 {
-    std::auto_ptr<BuildPlan> buildPlan = builder->translateGenome(genome);
-    if (buildPlan->size() > 1)
+    CppnGenome * parsed = parsedGenomes.find(digest);
+    if (parsed != NULL)
     {
-        return false;
+        return *parsed;
     }
-    return true;
+    std::stringstream stream(genome);
+    CppnGenome newGenome(stream);
+    parsedGenomes.put(digest, newGenome);
+    return newGenome;
+}
+
+
+boost::shared_ptr<MindGenome> EvolverController::parseMind(const std::string & digest, const std::string & mind)
+{
+    boost::shared_ptr<MindGenome> * parsed = parsedMinds.find(digest);
+    if (parsed != NULL)
+    {
+        return *parsed;
+    }
+    std::stringstream stream(mind);
+    boost::shared_ptr<MindGenome> newMind = mindGenomeManager->getGenomeFromStream(stream);
+    parsedMinds.put(digest, newMind);
+    return newMind;
+}
+
+
+bool EvolverController::checkEmptyPlan(CppnGenome genome)
+{
+    return !builder->hasModules(genome, 2);
 }
 
 
@@ -66,13 +129,15 @@ void EvolverController::sendGenomeToBirthClinic(std::string genome, std::string
     else
         fitness2Str = "/";
     
-    std::string message = "[GENOME_TO_CLINIC_MESSAGE]";
-    message = MessagesManager::add(message, "GENOME", genome);
-    message = MessagesManager::add(message, "MIND", newMind);
-    message = MessagesManager::add(message, "PARENTS", std::to_string(parent1) + "-" + std::to_string(parent2));
-    message = MessagesManager::add(message, "PARENTS_FITNESS", fitness1Str + "-" + fitness2Str);
+    Message message(GENOME_TO_CLINIC_MESSAGE);
+    genomeStore.addFull(message, "GENOME", genome);
+    genomeStore.addFull(message, "MIND", newMind);
+    message.add("PARENTS", std::to_string(parent1) + "-" + std::to_string(parent2));
+    message.add("PARENTS_FITNESS", fitness1Str + "-" + fitness2Str);
     
-    emitter->send(message.c_str(), (int)message.length()+1);
+    std::string data = message.encode();
+    emitter->send(data.data(), (int)data.size());
+    traffic.countSent(CLINIC_CHANNEL, data.size());
 }
 
 
@@ -81,32 +146,29 @@ void EvolverController::sendDeathMessage(id_t organimsId)
     emitter->setChannel(DEATH_CHANNEL);
     std::string message = std::to_string(organimsId);
     emitter->send(message.c_str(), (int)message.length()+1);
+    traffic.countSent(DEATH_CHANNEL, message.length()+1);
 }
 
 
-void EvolverController::readFitnessMessage(id_t * id, double * fitness, std::string * genome, std::string * mind, std::string message)
+bool EvolverController::readFitnessMessage(id_t * id, double * fitness, std::string * genome, std::string * mind, const MessageView & message)
 {
-    *id = std::atoi(MessagesManager::get(message, "ID").c_str());
-    std::string fitnessStr = MessagesManager::get(message, "FITNESS");
-    if (fitnessStr.compare("nan") == 0)
+    *id = message.getLong("ID");
+    if (message.get("FITNESS") == "nan")
         *fitness = 0.0;
     else
-        *fitness = std::atof(fitnessStr.c_str());
-    *genome = MessagesManager::get(message, "GENOME");
-    *mind = MessagesManager::get(message, "MIND");
+        *fitness = message.getDouble("FITNESS");
+    return genomeStore.resolve(message, "GENOME", genome) && genomeStore.resolve(message, "MIND", mind);
 }
 
 
-void EvolverController::readCoupleMessage(std::string message, id_t * id1, double * fitness1, std::string * genome1, std::string * mind1, id_t * id2, double * fitness2, std::string * genome2, std::string * mind2)
+bool EvolverController::readCoupleMessage(const MessageView & message, id_t * id1, double * fitness1, std::string * genome1, std::string * mind1, id_t * id2, double * fitness2, std::string * genome2, std::string * mind2, std::string digests[4])
 {
-    * id1 = std::atoi(MessagesManager::get(message, "ID1").c_str());
-    * fitness1 = std::atof(MessagesManager::get(message, "FITNESS1").c_str());
-    * genome1 = MessagesManager::get(message, "GENOME1");
-    * mind1 = MessagesManager::get(message, "MIND1");
-    * id2 = std::atoi(MessagesManager::get(message, "ID2").c_str());
-    * fitness2 = std::atof(MessagesManager::get(message, "FITNESS2").c_str());
-    * genome2 = MessagesManager::get(message, "GENOME2");
-    * mind2 = MessagesManager::get(message, "MIND2");
+    * id1 = message.getLong("ID1");
+    * fitness1 = message.getDouble("FITNESS1");
+    * id2 = message.getLong("ID2");
+    * fitness2 = message.getDouble("FITNESS2");
+    return genomeStore.resolve(message, "GENOME1", genome1, &digests[0]) && genomeStore.resolve(message, "MIND1", mind1, &digests[1]) &&
+        genomeStore.resolve(message, "GENOME2", genome2, &digests[2]) && genomeStore.resolve(message, "MIND2", mind2, &digests[3]);
 }
 
 
@@ -157,14 +219,7 @@ std::vector<id_t> EvolverController::selectForDying()
 
 int EvolverController::searchForOrganism(id_t organismId)
 {
-    for(int i = 0; i < organismsList.size(); i++)
-    {
-        if (organismsList[i].getId() == organismId)
-        {
-            return i;
-        }
-    }
-    return -1;
+    return organismsList.find(organismId);
 }
 
 void EvolverController::checkEndEvolution(double currentTime) {
@@ -172,11 +227,8 @@ void EvolverController::checkEndEvolution(double currentTime) {
     {
         if (checkEvolutionEnd())
         {
-            // set all prevoius organisms to DEAD state (should not be necessary though)
-            for (int i = 0; i < organismsList.size(); i++)
-            {
-                organismsList[i].setState(Organism::DEAD);
-            }
+            // archive all prevoius organisms (should not be necessary though)
+            organismsList.archiveAll();
             initialization = true;          // restart initialization procedure
             initialPopulationSize = 0;
             initPopulationWaitingTime = 0;  // immediately
@@ -188,72 +240,65 @@ void EvolverController::checkEndEvolution(double currentTime) {
 
 void EvolverController::storeEventOnFile(std::string log)
 {
-    ofstream organismsListsFile;
-    organismsListsFile.open(RESULTS_PATH + simulationDateAndTime + "/evolver_organisms_list.txt", ios::app);
-    organismsListsFile << log << std::endl;
-    organismsListsFile.close();
+    journal.write(RESULTS_PATH + simulationDateAndTime + "/evolver_organisms_list.txt", log + "\n");
 }
 
 
 void EvolverController::storeParentsOnFile(double currentTime)
 {
-    ofstream parentsFile;
-    boost::filesystem::path filePath = RESULTS_PATH + simulationDateAndTime + "/parents.txt";
-    if(!boost::filesystem::exists(filePath)){
-        parentsFile.open(filePath.string(), ios::app);
-        parentsFile << "#time id size fitness offspring state" << std::endl;
-    }else{
-        parentsFile.open(filePath.string(), ios::app);
-    }
+    std::ostringstream parentsFile;
     for (int i = 0; i < organismsList.size(); i++)
     {
-        Organism org = organismsList[i];
+        Organism & org = organismsList[i];
         if (org.getState() == Organism::ADULT)
         {
             parentsFile << currentTime << " " << org.getId() << " " << org.getSize() << " " << org.getFitness() << " " << org.getOffspring() << " " << org.getState() << " " << org.getFertile() << std::endl;
         }
     }
-    parentsFile.close();
+    journal.write(RESULTS_PATH + simulationDateAndTime + "/parents.txt", parentsFile.str(), "#time id size fitness offspring state\n");
 }
 
 void EvolverController::storePopulationSizesOnFile(double currentTime)
 {
-    ofstream parentsFile;
-    boost::filesystem::path filePath = RESULTS_PATH + simulationDateAndTime + "/populations.txt";
-    if(!boost::filesystem::exists(filePath)){
-        parentsFile.open(filePath.string(), ios::app);
-        parentsFile << "#time infants adults total" << std::endl;
-    }else{
-        parentsFile.open(filePath.string(), ios::app);
-    }
-    int infants = 0;
-    int adults = 0;
-    for (int i = 0; i < organismsList.size(); i++)
-    {
-        Organism org = organismsList[i];
-        if (org.getState() == Organism::INFANT){
-            infants++;
-        }else if (org.getState() == Organism::ADULT)
-        {
-            adults++;
-        }
-    }
-    parentsFile << currentTime << " " << infants << " " << adults << " " << (infants+adults) << std::endl;
-    parentsFile.close();
+    std::ostringstream parentsFile;
+    const OrganismRegistry::Statistics & statistics = organismsList.getStatistics();
+    parentsFile << currentTime << " " << statistics.infants << " " << statistics.adults << " " << (statistics.infants+statistics.adults) << std::endl;
+    journal.write(RESULTS_PATH + simulationDateAndTime + "/populations.txt", parentsFile.str(), "#time infants adults total\n");
+}
+
+void EvolverController::storePopulationStatisticsOnFile(double currentTime)
+{
+    std::ostringstream statisticsFile;
+    const OrganismRegistry::Statistics & statistics = organismsList.getStatistics();
+    statisticsFile << currentTime << " " << statistics.infants << " " << statistics.adults << " " << statistics.fertile << " "
+                   << statistics.modules << " " << statistics.getFitnessMean() << " " << statistics.getFitnessVariance() << " "
+                   << organismsList.getMaxFitness() << std::endl;
+    journal.write(RESULTS_PATH + simulationDateAndTime + "/population_statistics.txt", statisticsFile.str(),
+                  "#time infants adults fertile modules fitness_mean fitness_variance fitness_max\n");
 }
 
 
 void EvolverController::logListProblem(std::string event, std::string message, std::string fields)
 {
-    ofstream file;
-    file.open(RESULTS_PATH + simulationDateAndTime + "/list_problems.txt", ios::app);
+    std::ostringstream file;
     file << "TIME: " << getTime() << std::endl;
     file << "EVENT: " << event << std::endl;
     file << "MESSAGE:\n" << message << std::endl;
     file << "FIELDS:\n" << fields;
-    file << "LIST:\n" << getOrganismsListAsString() << std::endl;
+    file << "LIST: " << organismsList.size() << " organisms:" << getOrganismIdsAsString() << ", changes in organisms_delta.txt" << std::endl;
     file << std::endl;
-    file.close();
+    journal.write(RESULTS_PATH + simulationDateAndTime + "/list_problems.txt", file.str());
+}
+
+
+std::string EvolverController::getOrganismIdsAsString()
+{
+    std::ostringstream ids;
+    for (int i = 0; i < organismsList.size(); i++)
+    {
+        ids << " " << organismsList[i].getId();
+    }
+    return ids.str();
 }
 
 
@@ -267,59 +312,67 @@ int EvolverController::getRandomWait()
 }
 
 
-std::string EvolverController::getOrganismsListAsString()
+void EvolverController::storeOrganismsChange(OrganismRegistry::Change change, const Organism & organism)
 {
-    std::string text = "";
-    for (int i = 0; i < organismsList.size(); i++)
-    {
-        Organism org = organismsList[i];
-        text = text + std::to_string(i) + ") " + "ID: " + std::to_string(org.getId()) + "NAME: " + org.getName() + "STATE: " + std::to_string(org.getState()) + "\n";
-    }
-    return text;
+    journal.write(RESULTS_PATH + simulationDateAndTime + "/organisms_delta.txt",
+                  OrganismsHistory::format(getTime(), change, organism.getId(), organism.getState()), OrganismsHistory::HEADER);
 }
 
 ////////////////////////////////////////////////////////////////
 ////////////////////// MESSAGE FUNCTIONS ////?//////////////////
 ////////////////////////////////////////////////////////////////
 
-void EvolverController::deathMessage(std::string message, double currentTime) {
-    id_t organimsID = std::atoi(MessagesManager::get(message, "ID").c_str());
+void EvolverController::deathMessage(const MessageView & message, double currentTime) {
+    id_t organimsID = message.getLong("ID");
     int index = searchForOrganism(organimsID);
     
     if (index >= 0)
     {
-        if (organismsList[index].getState() != Organism::DEAD)
-        {
-            organismsList[index].setState(Organism::DEAD);
-            
-            logger.debugStream() << "organism_" << organimsID << " died: REMOVED FROM LIST";
-            
-            std::string log = std::to_string(getTime()) + " DEATH " + std::to_string(organimsID) + " organismsListSize " + std::to_string(organismsList.size());
-            storeEventOnFile(log);
-        }
+        organismsList.archive(index);
+        
+        logger.debugStream() << "organism_" << organimsID << " died: REMOVED FROM LIST";
+        
+        std::string log = std::to_string(getTime()) + " DEATH " + std::to_string(organimsID) + " organismsListSize " + std::to_string(organismsList.size());
+        storeEventOnFile(log);
     }
-    else
+    else if (organismsList.findArchived(organimsID) == NULL)
     {
         std::string fields = " ID: " + std::to_string(organimsID) + "\n";
         std::string event = " DEATH_ANNOUNCEMENT_MESSAGE";
-        logListProblem(event, message, fields);
+        logListProblem(event, message.toString(), fields);
     }
 }
 
-void EvolverController::birthMessage(std::string message, double currentTime) {
-    id_t parent1 = std::atoi(MessagesManager::get(message, "PARENT1").c_str());
-    id_t parent2 = std::atoi(MessagesManager::get(message, "PARENT2").c_str());
-    id_t organismId = std::atoi(MessagesManager::get(message, "ORGANISM_ID").c_str());
-    unsigned int size = std::atoi(MessagesManager::get(message, "SIZE").c_str());
-    std::string genome = MessagesManager::get(message, "GENOME");
-    std::string mind = MessagesManager::get(message, "MIND");
+void EvolverController::birthMessage(const MessageView & message, double currentTime) {
+    id_t parent1 = message.getLong("PARENT1");
+    id_t parent2 = message.getLong("PARENT2");
+    id_t organismId = message.getLong("ORGANISM_ID");
+    unsigned int size = message.getLong("SIZE");
+    std::string genome;
+    std::string mind;
+    std::string genomeDigest;
+    std::string mindDigest;
+    if (!genomeStore.resolve(message, "GENOME", &genome, &genomeDigest) || !genomeStore.resolve(message, "MIND", &mind, &mindDigest))
+    {
+        std::string event = " ORGANISM_BUILT_MESSAGE (unknown genome)";
+        std::string fields = " ORGANISM_ID: " + std::to_string(organismId) + "\n" +
+        " GENOME_DIGEST: " + message.get("GENOME_DIGEST").to_string() + "\n" +
+        " MIND_DIGEST: " + message.get("MIND_DIGEST").to_string() + "\n";
+        logListProblem(event, message.toString(), fields);
+        return;
+    }
     
     if(parent1 > 0){
         int index = searchForOrganism(parent1);
+        OrganismRegistry::ArchivedOrganism * archived = organismsList.findArchived(parent1);
         if (index >= 0)
         {
             organismsList[index].setOffspring(organismsList[index].getOffspring()+1);
         }
+        else if (archived != NULL)
+        {
+            archived->offspring++;
+        }
         else
         {
             std::string event = " ORGANISM_BUILT_MESSAGE (parent1)";
@@ -329,16 +382,21 @@ void EvolverController::birthMessage(std::string message, double currentTime) {
             " SIZE: " + std::to_string(size) + "\n" +
             " GENOME: " + genome + "\n" +
             " MIND: " + mind + "\n";
-            logListProblem(event, message, fields);
+            logListProblem(event, message.toString(), fields);
         }
     }
     
     if(parent2 > 0){
         int index = searchForOrganism(parent2);
+        OrganismRegistry::ArchivedOrganism * archived = organismsList.findArchived(parent2);
         if (index >= 0)
         {
             organismsList[index].setOffspring(organismsList[index].getOffspring()+1);
         }
+        else if (archived != NULL)
+        {
+            archived->offspring++;
+        }
         else
         {
             std::string event = " ORGANISM_BUILT_MESSAGE (parent2)";
@@ -348,7 +406,7 @@ void EvolverController::birthMessage(std::string message, double currentTime) {
             " SIZE: " + std::to_string(size) + "\n" +
             " GENOME: " + genome + "\n" +
             " MIND: " + mind + "\n";
-            logListProblem(event, message, fields);
+            logListProblem(event, message.toString(), fields);
         }
         
     }
@@ -358,126 +416,121 @@ void EvolverController::birthMessage(std::string message, double currentTime) {
     parents.push_back(parent2);
     
     Organism newOrganism = Organism(genome, mind, organismId, 0, size, 0, parents, Organism::INFANT, false);
+    newOrganism.setDigests(genomeDigest, mindDigest);
     int idx = searchForOrganism(organismId);
     if (idx >= 0)
     {
-        std::string before = getOrganismsListAsString();
+        std::string before = getOrganismIdsAsString();
         
-        organismsList.erase(organismsList.begin()+idx);
+        organismsList.remove(idx);
         
-        std::string after = getOrganismsListAsString();
-        
-        ofstream file;
-        file.open(RESULTS_PATH + simulationDateAndTime + "/already_there.txt", ios::app);
+        std::ostringstream file;
         file << std::endl;
-        file << "organism " << organismId << " was already inside the list, in position " << idx << std::endl;
-        file << "list before:" << std::endl << before << std::endl;
-        file << "list after:" << std::endl << after << std::endl;
-        file.close();
+        file << "organism " << organismId << " was already inside the list, in position " << idx << " at time " << getTime() << std::endl;
+        file << "list before:" << before << std::endl;
+        journal.write(RESULTS_PATH + simulationDateAndTime + "/already_there.txt", file.str());
 
     }
-    organismsList.push_back(newOrganism);
-    
-    ofstream file2;
-    file2.open(RESULTS_PATH + simulationDateAndTime + "/added.txt", ios::app);
-    file2 << std::endl;
-    file2 << "organism " << organismId << " added to list " << std::endl;
-    file2 << "list:" << std::endl << getOrganismsListAsString() << std::endl;
-    file2.close();
+    organismsList.add(newOrganism);
     
     std::string log = std::to_string(getTime()) + " PROCREATE " + std::to_string(parent1) + " and "  + std::to_string(parent2) + " successfully had child " + std::to_string(organismId);
     storeEventOnFile(log);
 }
 
-void EvolverController::adultMessage(std::string message, double currentTime) {
-    id_t organismId = atoi(MessagesManager::get(message, "ID").c_str());
+void EvolverController::adultMessage(const MessageView & message, double currentTime) {
+    id_t organismId = message.getLong("ID");
     int idx = searchForOrganism(organismId);
     if (idx >= 0)
     {
-        organismsList[searchForOrganism(organismId)].setState(Organism::ADULT);
+        organismsList.setState(idx, Organism::ADULT);
     }
-    else
+    else if (organismsList.findArchived(organismId) == NULL)
     {
         std::string event = " ADULT_ANNOUNCEMENT";
         std::string fields = " ID: " + std::to_string(organismId) + "\n";
-        logListProblem(event, message, fields);
+        logListProblem(event, message.toString(), fields);
     }
 }
 
-void EvolverController::fertileMessage(std::string message, double currentTime) {
-    id_t organismId = atoi(MessagesManager::get(message, "ID").c_str());
+void EvolverController::fertileMessage(const MessageView & message, double currentTime) {
+    id_t organismId = message.getLong("ID");
     int idx = searchForOrganism(organismId);
     if (idx >= 0)
     {
-        organismsList[searchForOrganism(organismId)].setFertile(true);
+        organismsList.setFertile(idx, true);
     }
-    else
+    else if (organismsList.findArchived(organismId) == NULL)
     {
         std::string event = " FERTILE_ANNOUNCEMENT";
         std::string fields = " ID: " + std::to_string(organismId) + "\n";
-        logListProblem(event, message, fields);
+        logListProblem(event, message.toString(), fields);
     }
 }
 
-void EvolverController::fitnessUpdateMessage(std::string message, double currentTime) {
-    id_t organismId = atoi(MessagesManager::get(message, "ID").c_str());
-    double fitness = atof(MessagesManager::get(message, "FITNESS").c_str());
+void EvolverController::fitnessUpdateMessage(const MessageView & message, double currentTime) {
+    id_t organismId = message.getLong("ID");
+    double fitness = 0.0;
+    if (message.get("FITNESS") != "nan")
+        fitness = message.getDouble("FITNESS");
     int idx = searchForOrganism(organismId);
+    OrganismRegistry::ArchivedOrganism * archived = organismsList.findArchived(organismId);
     if (idx >= 0)
     {
-        organismsList[searchForOrganism(organismId)].setFitness(fitness);
+        organismsList.setFitness(idx, fitness);
+    }
+    else if (archived != NULL)
+    {
+        archived->fitness = fitness;
     }
     else
     {
         std::string event = " FITNESS_UPDATE";
         std::string fields = " ID: " + std::to_string(organismId) + "\n" + "FITNESS: " + std::to_string(fitness) + "\n";
-        logListProblem(event, message, fields);
+        logListProblem(event, message.toString(), fields);
     }
 }
 
-void EvolverController::coupleMessage(std::string message,double currentTime) {
+void EvolverController::coupleMessage(const MessageView & message, double currentTime) {
     try {
         // read message with couple
         id_t id1, id2;
         double fitness1, fitness2;
         std::string genome1, genome2;
         std::string mind1, mind2;
-        readCoupleMessage(message, & id1, & fitness1, & genome1, & mind1, & id2, & fitness2, & genome2, & mind2);
+        std::string digests[4];
+        if (!readCoupleMessage(message, & id1, & fitness1, & genome1, & mind1, & id2, & fitness2, & genome2, & mind2, digests))
+        {
+            std::string event = " COUPLE_MESSAGE (unknown genome)";
+            std::string fields = " ID1: " + std::to_string(id1) + "\n" + " ID2: " + std::to_string(id2) + "\n";
+            logListProblem(event, message.toString(), fields);
+            return;
+        }
         
         // recombine genomes
         std::vector<CppnGenome> parentsGenomes = std::vector<CppnGenome>();
-        std::stringstream genomeAsStream1(genome1);
-        std::stringstream genomeAsStream2(genome2);
-        parentsGenomes.push_back(CppnGenome(genomeAsStream1));
-        parentsGenomes.push_back(CppnGenome(genomeAsStream2));
+        parentsGenomes.push_back(parseGenome(digests[0], genome1));
+        parentsGenomes.push_back(parseGenome(digests[2], genome2));
         
-        bool empty = true;
-        for (int i = 0; i < 100 && empty; i ++)
+        std::unique_ptr<CppnGenome> newGenome = createOffspring(parentsGenomes);
+        if (newGenome)
         {
-            CppnGenome newGenome = genomeManager->createGenome(parentsGenomes);
-            empty = checkEmptyPlan(newGenome);
+            // recombine minds
+            std::vector<boost::shared_ptr<MindGenome> > parentMindGenomes;
+            parentMindGenomes.push_back(parseMind(digests[1], mind1));
+            parentMindGenomes.push_back(parseMind(digests[3], mind2));
+            boost::shared_ptr<MindGenome> newMind = mindGenomeManager->createGenome(parentMindGenomes);
             
-            if(!empty) {
-                // recombine minds
-                std::vector<boost::shared_ptr<MindGenome> > parentMindGenomes;
-                std::stringstream mindAsStream1(mind1);
-                std::stringstream mindAsStream2(mind2);
-                parentMindGenomes.push_back(mindGenomeManager->getGenomeFromStream(mindAsStream1));
-                parentMindGenomes.push_back(mindGenomeManager->getGenomeFromStream(mindAsStream2));
-                boost::shared_ptr<MindGenome> newMind = mindGenomeManager->createGenome(parentMindGenomes);
-                
-                logger.debugStream() << "NEW GENOME CREATED FROM organism_" << id1 << " and organism_" << id2;
-                
-                // store event into file
-                std::string log = std::to_string(getTime()) + " NEW GENOME CREATED FROM " + std::to_string(id1) + " and " + std::to_string(id2);
-                storeEventOnFile(log);
-                
-                // send new genome to birth clinic
-                sendGenomeToBirthClinic(genomeManager->genomeToString(newGenome), newMind->toString(), id1, id2, fitness1, fitness2);
-                
-                // stop initialization
-                initialization = false;
-            }
+            logger.debugStream() << "NEW GENOME CREATED FROM organism_" << id1 << " and organism_" << id2;
+            
+            // store event into file
+            std::string log = std::to_string(getTime()) + " NEW GENOME CREATED FROM " + std::to_string(id1) + " and " + std::to_string(id2);
+            storeEventOnFile(log);
+            
+            // send new genome to birth clinic
+            sendGenomeToBirthClinic(genomeManager->genomeToString(*newGenome), newMind->toString(), id1, id2, fitness1, fitness2);
+            
+            // stop initialization
+            initialization = false;
         }
     }catch(LocatedException &e){
         logger.warnStream() << "Couple Mating failed, genomeManager threw a located exception: " << e.what();
@@ -486,24 +539,33 @@ void EvolverController::coupleMessage(std::string message,double currentTime) {
     }
 }
 
-void EvolverController::genomeSpreadMessage(std::string message, double currentTime) {
+void EvolverController::genomeSpreadMessage(const MessageView & message, double currentTime) {
     id_t organismId;
     double fitness;
     std::string genomeStr;
     std::string mindStr;
-    readFitnessMessage(& organismId, & fitness, &genomeStr, &mindStr, message);
+    bool genomesKnown = readFitnessMessage(& organismId, & fitness, &genomeStr, &mindStr, message);
     
     int idx = searchForOrganism(organismId);
+    OrganismRegistry::ArchivedOrganism * archived = organismsList.findArchived(organismId);
     if (idx >= 0)
     {
         // update fitness and state
-        organismsList[idx].setFitness(fitness);
-        organismsList[idx].setState(Organism::ADULT);   // redundant
-        organismsList[idx].setMind(mindStr);            // useful only for the first message from organisms not created from parents
+        organismsList.setFitness(idx, fitness);
+        organismsList.setState(idx, Organism::ADULT);   // redundant
+        if (genomesKnown)
+        {
+            organismsList[idx].setMind(mindStr);            // useful only for the first message from organisms not created from parents
+        }
         
         std::string log = std::to_string(getTime()) + " MESSAGE_FROM " + std::to_string(organismId)  + " organismsListSize " + std::to_string(organismsList.size());
         storeEventOnFile(log);
     }
+    else if (archived != NULL)
+    {
+        // sent before the organism died, it stays dead
+        archived->fitness = fitness;
+    }
     else
     {
         std::string event = " GENOME_SPREAD_MESSAGE";
@@ -511,7 +573,73 @@ void EvolverController::genomeSpreadMessage(std::string message, double currentT
         " FITNESS: " + std::to_string(fitness) + "\n" +
         " GENOME: " + genomeStr + "\n" +
         " MIND: " + mindStr + "\n";
-        logListProblem(event, message, fields);
+        logListProblem(event, message.toString(), fields);
+    }
+}
+
+void EvolverController::registerMessageHandlers()
+{
+    /**************************************
+     ****** UPDATE BECAUSE OF DEATH  ******
+     **************************************/
+    messageDispatcher.registerHandler(DEATH_ANNOUNCEMENT_MESSAGE, [this](const MessageView & message) {
+        deathMessage(message, currentTime);
+        return true;
+    });
+    
+    /*************************************
+     ****** UPDATE BECAUSE OF BIRTH ******
+     *************************************/
+    messageDispatcher.registerHandler(ORGANISM_BUILT_MESSAGE, [this](const MessageView & message) {
+        birthMessage(message, currentTime);
+        return true;
+    });
+    
+    /*************************************
+     ****** UPDATE BECAUSE OF ADULT ******
+     *************************************/
+    messageDispatcher.registerHandler(ADULT_ANNOUNCEMENT, [this](const MessageView & message) {
+        adultMessage(message, currentTime);
+        return true;
+    });
+    
+    /*************************************
+     ***** UPDATE BECAUSE OF FERTILE *****
+     *************************************/
+    messageDispatcher.registerHandler(FERTILE_ANNOUNCEMENT, [this](const MessageView & message) {
+        fertileMessage(message, currentTime);
+        return true;
+    });
+    
+    /******************************
+     ******* UPDATE FITNESS *******
+     ******************************/
+    // should be useful only for distributed
+    messageDispatcher.registerHandler(FITNESS_UPDATE, [this](const MessageView & message) {
+        fitnessUpdateMessage(message, currentTime);
+        return true;
+    });
+    
+    /**************************************************************
+     ******* CREATE NEW GENOME AFTER SELECTION BY ORGANISMS *******
+     **************************************************************/
+    if (matingType == MATING_SELECTION_BY_ORGANISMS)
+    {
+        messageDispatcher.registerHandler(COUPLE_MESSAGE, [this](const MessageView & message) {
+            coupleMessage(message, currentTime);
+            return true;
+        });
+    }
+    
+    /*************************************************
+     ******* GET GENOMES FOR MATING BY EVOLVER *******
+     *************************************************/
+    if (matingType == MATING_SELECTION_BY_EVOLVER)
+    {
+        messageDispatcher.registerHandler(GENOME_SPREAD_MESSAGE, [this](const MessageView & message) {
+            genomeSpreadMessage(message, currentTime);
+            return true;
+        });
     }
 }
 
@@ -521,8 +649,28 @@ void EvolverController::genomeSpreadMessage(std::string message, double currentT
 
 
 EvolverController::EvolverController() : Supervisor(),
-logger(Logger::getInstance("EvolverController"))
+logger(Logger::getInstance("EvolverController")),
+genomeStore(GENOME_STORE_SIZE),
+parsedGenomes(PARSED_GENOME_CACHE_SIZE),
+parsedMinds(PARSED_GENOME_CACHE_SIZE),
+offspringWorkers(OFFSPRING_WORKERS),
+journal(JOURNAL_BUFFER_SIZE, JOURNAL_FLUSH_INTERVAL)
 {
+    organismsList.setChangeListener([this](OrganismRegistry::Change change, const Organism & organism) {
+        // the genomes of the live organisms stay in the store, the others only while recently used
+        if (change == OrganismRegistry::ADDED)
+        {
+            genomeStore.hold(organism.getGenomeDigest());
+            genomeStore.hold(organism.getMindDigest());
+        }
+        else if (change == OrganismRegistry::REMOVED)
+        {
+            genomeStore.release(organism.getGenomeDigest());
+            genomeStore.release(organism.getMindDigest());
+        }
+        storeOrganismsChange(change, organism);
+    });
+    
     // setup shape encoding
     if (SHAPE_ENCODING == "CPPN")
     {
@@ -568,9 +716,11 @@ logger(Logger::getInstance("EvolverController"))
         logger.errorStream() << "Unknown Death Selection Mechanism: " << DEATH_SELECTION;
     }
     
-    emitter = getEmitter(EMITTER_NAME);
+    Receiver * receiverDevice = getReceiver(RECEIVER_NAME);
+    receiverDevice->enable(getBasicTimeStep());
+    emitter.reset(new WebotsEmitter(getEmitter(EMITTER_NAME)));
     emitter->setChannel(CLINIC_CHANNEL);
-    receiver = getReceiver(RECEIVER_NAME);
+    receiver.reset(new WebotsReceiver(receiverDevice));
     receiver->setChannel(EVOLVER_CHANNEL);
     
     builder = new Builder();
@@ -587,12 +737,13 @@ void EvolverController::run()
 {
     double TIME_STEP = getBasicTimeStep();
     
-    receiver->enable(TIME_STEP);
     while (receiver->getQueueLength() > 0)
     {
         receiver->nextPacket();
     }
     
+    connectModules();
+    
     
     /****************************************
      ***** WAIT UNTIL ENVIRONMENT IS OK *****
@@ -604,11 +755,11 @@ void EvolverController::run()
     {
         while(receiver->getQueueLength() > 0)
         {
-            std::string message = (char*)receiver->getData();
-            if (message.substr(0,24).compare("[ENVIRONMENT_OK_MESSAGE]") == 0)
+            MessageView message(receiver->getData(), receiver->getDataSize());
+            if (message.getType() == ENVIRONMENT_OK_MESSAGE)
             {
                 environmentOk = true;
-                simulationDateAndTime = MessagesManager::get(message, "SDAT");
+                simulationDateAndTime = message.get("SDAT").to_string();
             }
             receiver->nextPacket();
         }
@@ -627,6 +778,8 @@ void EvolverController::run()
     
     // MAIN CYCLE
     
+    registerMessageHandlers();
+    
     initialization = true;
     initPopulationWaitingTime = getRandomWait();
     initialPopulationSize = 0;
@@ -636,6 +789,7 @@ void EvolverController::run()
     lastDeath = 0;       // FOR CENTRALIZED DEATH BY THE EVOLVER
     lastEvolutionEndCheck = 0;
     lastOffspringLoggingTime = 30;
+    lastTrafficLogging = 0;
     
     logger.noticeStream() << BOLDGREEN << "Initializing next individual in " << initPopulationWaitingTime << " seconds" << RESET;
     while (step(TIME_STEP) != -1)
@@ -675,75 +829,12 @@ void EvolverController::run()
         /***************************************************************
          ************************** MANAGE MESSAGES ********************
          ***************************************************************/
+        traffic.countQueueLength(EVOLVER_CHANNEL, receiver->getQueueLength());
         while(receiver->getQueueLength() > 0)
         {
-            std::string message = (char*)receiver->getData();
-            
-            /**************************************
-             ****** UPDATE BECAUSE OF DEATH  ******
-             **************************************/
-            if (message.substr(0,28).compare("[DEATH_ANNOUNCEMENT_MESSAGE]") == 0)
-            {
-                deathMessage(message,currentTime);
-            }
-            
-            /*************************************
-             ****** UPDATE BECAUSE OF BIRTH ******
-             *************************************/
-            else if (message.substr(0,24).compare("[ORGANISM_BUILT_MESSAGE]") == 0)
-            {
-                birthMessage(message,currentTime);
-            }
-            
-            /*************************************
-             ****** UPDATE BECAUSE OF ADULT ******
-             *************************************/
-            else if (message.substr(0,20).compare("[ADULT_ANNOUNCEMENT]") == 0)
-            {
-                adultMessage(message,currentTime);
-            }
-            
-            /*************************************
-             ***** UPDATE BECAUSE OF FERTILE *****
-             *************************************/
-            else if (message.substr(0,20).compare("[FERTILE_ANNOUNCEMENT]") == 0)
-            {
-                fertileMessage(message,currentTime);
-            }
-            
-            /******************************
-             ******* UPDATE FITNESS *******
-             ******************************/
-            // should be useful only for distributed
-            else if (message.substr(0,16).compare("[FITNESS_UPDATE]") == 0)
-            {
-                fitnessUpdateMessage(message,currentTime);
-            }
-            
-            /**************************************************************
-             ******* CREATE NEW GENOME AFTER SELECTION BY ORGANISMS *******
-             **************************************************************/
-            else if (matingType == MATING_SELECTION_BY_ORGANISMS)
-            {
-                
-                if (message.substr(0,16).compare("[COUPLE_MESSAGE]") == 0)
-                {
-                    coupleMessage(message,currentTime);
-                }
-            }
-            
-            /*************************************************
-             ******* GET GENOMES FOR MATING BY EVOLVER *******
-             *************************************************/
-            else if (matingType == MATING_SELECTION_BY_EVOLVER)
-            {
-            
-                if (message.substr(0,23).compare("[GENOME_SPREAD_MESSAGE]") == 0)
-                {
-                    genomeSpreadMessage(message,currentTime);
-                }
-            }
-            
+            MessageView message(receiver->getData(), receiver->getDataSize());
+            messageDispatcher.dispatch(message);
+            traffic.countReceived(EVOLVER_CHANNEL, receiver->getDataSize());
             receiver->nextPacket();
         }
         
@@ -767,42 +858,35 @@ void EvolverController::run()
                 {
                     try {
                         std::vector<CppnGenome> parentsGenomes = std::vector<CppnGenome>();
-                        std::stringstream stream1(organismsList[searchForOrganism(forMating[0])].getGenome());
-                        std::stringstream stream2(organismsList[searchForOrganism(forMating[1])].getGenome());
+                        const Organism & parent1 = organismsList[searchForOrganism(forMating[0])];
+                        const Organism & parent2 = organismsList[searchForOrganism(forMating[1])];
                         
-                        parentsGenomes.push_back(CppnGenome(stream1));
-                        parentsGenomes.push_back(CppnGenome(stream2));
+                        // the digests were kept when the organisms were born, the cache keys cost no hashing
+                        parentsGenomes.push_back(parseGenome(parent1.getGenomeDigest(), parent1.getGenome()));
+                        parentsGenomes.push_back(parseGenome(parent2.getGenomeDigest(), parent2.getGenome()));
                         
-                        bool empty = true;
-                        for (int i = 0; i < 100 && empty; i++)
+                        std::unique_ptr<CppnGenome> newGenome = createOffspring(parentsGenomes);
+                        if (newGenome)
                         {
-                            CppnGenome newGenome = genomeManager->createGenome(parentsGenomes);
-                            empty = checkEmptyPlan(newGenome);
-                        
-                            if(!empty) {
-                                std::vector<boost::shared_ptr<MindGenome> > parentMindGenomes;
-                                std::stringstream mind1(organismsList[searchForOrganism(forMating[0])].getMind());
-                                std::stringstream mind2(organismsList[searchForOrganism(forMating[1])].getMind());
-                                
-                                boost::shared_ptr<MindGenome> mindGenome1 = mindGenomeManager->getGenomeFromStream(mind1);
-                                boost::shared_ptr<MindGenome> mindGenome2 = mindGenomeManager->getGenomeFromStream(mind2);
-                                
-                                parentMindGenomes.push_back(mindGenome1);
-                                parentMindGenomes.push_back(mindGenome2);
-                                boost::shared_ptr<MindGenome> newMind = mindGenomeManager->createGenome(parentMindGenomes);
-                                
-                                logger.debugStream() << "NEW GENOME CREATED FROM organism_" << forMating[0] << " and organism_" << forMating[1];
-                                
-                                std::string log = std::to_string(getTime()) + " NEW GENOME CREATED FROM " + std::to_string(forMating[0]) + " and " + std::to_string(forMating[1]);
-                                storeEventOnFile(log);
-                                
-                                double fitness1 = organismsList[searchForOrganism(forMating[0])].getFitness();
-                                double fitness2 = organismsList[searchForOrganism(forMating[1])].getFitness();
-                                sendGenomeToBirthClinic(genomeManager->genomeToString(newGenome), newMind->toString(), forMating[0], forMating[1], fitness1, fitness2);
-                                
-                                initialization = false;
-                                logger.noticeStream() << BOLDGREEN << "Finished initialising population" << RESET;
-                            }
+                            std::vector<boost::shared_ptr<MindGenome> > parentMindGenomes;
+                            boost::shared_ptr<MindGenome> mindGenome1 = parseMind(parent1.getMindDigest(), parent1.getMind());
+                            boost::shared_ptr<MindGenome> mindGenome2 = parseMind(parent2.getMindDigest(), parent2.getMind());
+                            
+                            parentMindGenomes.push_back(mindGenome1);
+                            parentMindGenomes.push_back(mindGenome2);
+                            boost::shared_ptr<MindGenome> newMind = mindGenomeManager->createGenome(parentMindGenomes);
+                            
+                            logger.debugStream() << "NEW GENOME CREATED FROM organism_" << forMating[0] << " and organism_" << forMating[1];
+                            
+                            std::string log = std::to_string(getTime()) + " NEW GENOME CREATED FROM " + std::to_string(forMating[0]) + " and " + std::to_string(forMating[1]);
+                            storeEventOnFile(log);
+                            
+                            double fitness1 = parent1.getFitness();
+                            double fitness2 = parent2.getFitness();
+                            sendGenomeToBirthClinic(genomeManager->genomeToString(*newGenome), newMind->toString(), forMating[0], forMating[1], fitness1, fitness2);
+                            
+                            initialization = false;
+                            logger.noticeStream() << BOLDGREEN << "Finished initialising population" << RESET;
                         }
                     }catch(LocatedException &e){
                         logger.warnStream() << "Evolver Mating failed, genomeManager threw a located exception: " << e.what();
@@ -814,35 +898,28 @@ void EvolverController::run()
                 {
                     try{
                         std::vector<CppnGenome> parentsGenomes = std::vector<CppnGenome>();
-                        std::stringstream stream1(organismsList[searchForOrganism(forMating[0])].getGenome());
+                        const Organism & parent = organismsList[searchForOrganism(forMating[0])];
                         
-                        parentsGenomes.push_back(CppnGenome(stream1));
+                        parentsGenomes.push_back(parseGenome(parent.getGenomeDigest(), parent.getGenome()));
                         
-                        bool empty = true;
-                        for (int i = 0; i < 100 && empty; i++)
+                        std::unique_ptr<CppnGenome> newGenome = createOffspring(parentsGenomes);
+                        if (newGenome)
                         {
-                            CppnGenome newGenome = genomeManager->createGenome(parentsGenomes);
-                            empty = checkEmptyPlan(newGenome);
-                        
-                            if(!empty){
-                                std::vector<boost::shared_ptr<MindGenome> > parentMindGenomes;
-                                std::stringstream mind1(organismsList[searchForOrganism(forMating[0])].getMind());
-
-                                boost::shared_ptr<MindGenome> mindGenome1 = mindGenomeManager->getGenomeFromStream(mind1);
-                                
-                                parentMindGenomes.push_back(mindGenome1);
-                                boost::shared_ptr<MindGenome> newMind = mindGenomeManager->createGenome(parentMindGenomes);
-                                
-                                logger.debugStream() << "NEW GENOME CREATED FROM SINGLE PARENT organism_" << forMating[0];
-                                
-                                std::string log = std::to_string(getTime()) + " NEW GENOME CREATED FROM " + std::to_string(forMating[0]);
-                                storeEventOnFile(log);
-                                
-                                double fitness = organismsList[searchForOrganism(forMating[0])].getFitness();
-                                sendGenomeToBirthClinic(genomeManager->genomeToString(newGenome), newMind->toString(), forMating[0], 0, fitness, -1);
-                                
-                                initialization = false;
-                            }
+                            std::vector<boost::shared_ptr<MindGenome> > parentMindGenomes;
+                            boost::shared_ptr<MindGenome> mindGenome1 = parseMind(parent.getMindDigest(), parent.getMind());
+                            
+                            parentMindGenomes.push_back(mindGenome1);
+                            boost::shared_ptr<MindGenome> newMind = mindGenomeManager->createGenome(parentMindGenomes);
+                            
+                            logger.debugStream() << "NEW GENOME CREATED FROM SINGLE PARENT organism_" << forMating[0];
+                            
+                            std::string log = std::to_string(getTime()) + " NEW GENOME CREATED FROM " + std::to_string(forMating[0]);
+                            storeEventOnFile(log);
+                            
+                            double fitness = parent.getFitness();
+                            sendGenomeToBirthClinic(genomeManager->genomeToString(*newGenome), newMind->toString(), forMating[0], 0, fitness, -1);
+                            
+                            initialization = false;
                         }
                     }catch(LocatedException &e){
                         logger.warnStream() << "Evolver Mating failed, genomeManager threw a located exception: " << e.what();
@@ -868,9 +945,22 @@ void EvolverController::run()
         if(currentTime - lastOffspringLoggingTime > MATING_TIME)
         {
             storeParentsOnFile(currentTime);
+            storePopulationStatisticsOnFile(currentTime);
+            logger.debugStream() << "received messages:\n" << messageDispatcher.getStatistics();
+            logger.debugStream() << "parsed genomes cache: " << parsedGenomes.getHits() << " hits, " << parsedGenomes.getMisses() << " misses; "
+                                 << "parsed minds cache: " << parsedMinds.getHits() << " hits, " << parsedMinds.getMisses() << " misses";
             lastOffspringLoggingTime = getTime();
         }
         
+        /***********************************
+         *********** LOG TRAFFIC ***********
+         ***********************************/
+        if(currentTime - lastTrafficLogging > TRAFFIC_LOGGING_INTERVAL)
+        {
+            traffic.store(RESULTS_PATH + simulationDateAndTime + "/traffic.txt", "evolver", currentTime);
+            lastTrafficLogging = currentTime;
+        }
+        
         /******************************************
          ******* DEATH BY EVOLVER SELECTION *******
          ******************************************/
@@ -892,4 +982,7 @@ void EvolverController::run()
         }
         
     }
+    
+    // the simulation was reverted or quit: the controller is killed shortly after
+    journal.flush();
 }
\ No newline at end of file
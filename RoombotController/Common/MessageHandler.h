@@ -9,42 +9,146 @@
 #ifndef RoombotController_MessagesHandler_h
 #define RoombotController_MessagesHandler_h
 
-#include <webots/Robot.hpp>
-using namespace webots;
+#include "Radio.h"
+#include "Message.h"
+#include "MessageView.h"
+#include "ChannelTraffic.h"
+
+#include <cstring>
 
 class MessageHandler {
 public:
     MessageHandler() {
         emitter = NULL;
         receiver = NULL;
+        traffic = NULL;
     }
     
-    MessageHandler(Emitter *em, Receiver *recv) :
+    MessageHandler(RadioEmitter *em, RadioReceiver *recv) :
         emitter(em),
-        receiver(recv)
+        receiver(recv),
+        traffic(NULL)
     {
     }
     
     void send(std::string message){
+        if(emitter) {
+            flush();
+            emit(message.c_str(), message.length()+1);
+        }
+    }
+    
+    void send(const char * data, size_t size){
+        if(emitter) {
+            flush();
+            emit(data, size);
+        }
+    }
+    
+    void send(const Message & message){
+        if(emitter) {
+            flush();
+            std::string data = message.encode();
+            emit(data.data(), data.size());
+        }
+    }
+    
+    /**
+     * Keeps a message to be sent with the next flush(), together with the other ones queued
+     * during the same step, so that status updates cost one packet per step.
+     */
+    void queue(const Message & message){
         if(emitter)
-            emitter->send(message.c_str(), message.length()+1);
+            queued.push_back(message.encode());
+    }
+    
+    /**
+     * Sends the queued messages: alone if there is only one, as a BATCH_MESSAGE otherwise.
+     * Called at the end of every step, and before anything else is sent or the channel changes
+     * so that the receivers see the messages in order.
+     */
+    void flush(){
+        if(!emitter || queued.empty())
+            return;
+        
+        if(queued.size() == 1) {
+            emit(queued[0].data(), queued[0].size());
+        } else {
+            Message batch(BATCH_MESSAGE);
+            for(size_t i = 0; i < queued.size(); i++) {
+                batch.add("RECORD", queued[i]);
+            }
+            std::string data = batch.encode();
+            emit(data.data(), data.size());
+        }
+        queued.clear();
+    }
+    
+    /**
+     * @return The data of the packet at the head of the queue, without copying it.
+     *         Only valid until next() is called; empty if there is no packet.
+     */
+    boost::string_ref receiveData() {
+        if(receiver && receiver->getQueueLength() > 0) {
+            return boost::string_ref((const char *)receiver->getData(), receiver->getDataSize());
+        } else {
+            return boost::string_ref();
+        }
+    }
+    
+    /**
+     * @return A view on the message at the head of the queue, only valid until next() is called.
+     *         An UNKNOWN_MESSAGE if there is no packet.
+     */
+    MessageView receiveView() {
+        boost::string_ref data = receiveData();
+        return MessageView(data.data(), data.size());
     }
     
+    /**
+     * @return A copy of the text packet at the head of the queue, empty if there is no packet.
+     */
     std::string receive() {
+        boost::string_ref data = receiveData();
+        if(data.empty()) {
+            return std::string();
+        }
+        return std::string(data.data(), strnlen(data.data(), data.size()));
+    }
+    
+    Message receiveMessage() {
         if(receiver) {
-            std::string message((char*)receiver->getData());
-            return message;
+            return Message::decode(receiver->getData(), receiver->getDataSize());
         } else {
-            return NULL;
+            return Message();
         }
     }
     
     void next() {
         if(receiver) {
+            if(traffic && receiver->getQueueLength() > 0) {
+                traffic->countReceived(receiver->getChannel(), receiver->getDataSize());
+            }
             receiver->nextPacket();
         }
     }
     
+    /**
+     * Counts the packets and bytes sent and received from now on in the given counters.
+     */
+    void setTraffic(ChannelTraffic *counters) {
+        traffic = counters;
+    }
+    
+    /**
+     * Samples the length of the receiver queue, to be called once per step.
+     */
+    void countQueueLength() {
+        if(traffic && receiver) {
+            traffic->countQueueLength(receiver->getChannel(), receiver->getQueueLength());
+        }
+    }
+    
     bool hasMessage() {
         if(receiver) {
             return receiver->getQueueLength() > 0;
@@ -55,6 +159,7 @@ public:
     
     void setChannel(int channel) {
         if(emitter) {
+            flush();
             emitter->setChannel(channel);
         }
         if(receiver) {
@@ -63,13 +168,17 @@ public:
     }
     
     void setEmitterRange(double range) {
-        if(emitter)
+        if(emitter) {
+            flush();
             emitter->setRange(range);
+        }
     }
 
     void setEmitterChannel(int channel) {
-        if(emitter)
+        if(emitter) {
+            flush();
             emitter->setChannel(channel);
+        }
     }
     
     void setReceiverChannel(int channel) {
@@ -77,17 +186,26 @@ public:
             receiver->setChannel(channel);
     }
     
-    Emitter *getEmitter() {
+    RadioEmitter *getEmitter() {
         return emitter;
     }
     
-    Receiver *getReceiver() {
+    RadioReceiver *getReceiver() {
         return receiver;
     }
     
 private:
-    Emitter *emitter;
-    Receiver *receiver;
+    void emit(const char * data, size_t size) {
+        if(traffic) {
+            traffic->countSent(emitter->getChannel(), size);
+        }
+        emitter->send(data, (int)size);
+    }
+    
+    RadioEmitter *emitter;
+    RadioReceiver *receiver;
+    ChannelTraffic *traffic;
+    std::vector<std::string> queued;
 };
 
 #endif
@@ -18,6 +18,7 @@
 #include "Defines.h"
 #include "JGTL/JGTL_Vector3.h"
 #include "Logger.h"
+#include "GenomeStore.h"
 
 class WorldModel {
 public:
@@ -53,6 +54,8 @@ public:
     std::string mindGenome;
     std::string bodyGenome;
     
+    GenomeStore genomeStore;                // genomes sent and received, messages refer to them by digest
+    
     JGTL::Vector3<double> position;
 
     // check if a module is root
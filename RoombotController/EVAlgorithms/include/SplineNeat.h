@@ -24,6 +24,10 @@
 #include <boost/random/uniform_int_distribution.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include "BatchedNetwork.h"
+#include "CompiledNetwork.h"
+#include "ParametersReader.h"
+
 #include "Globals.h"
 #include "Values.h"
 #include "Policy.h"
@@ -81,6 +85,22 @@ private:
      */
     void initializePolicy();
     
+    /**
+     * Fills the splines of the current individual with a CompiledNetwork,
+     * updating it for every sample like initializePolicy() does with the cppn
+     *
+     * @return false, without changing splines, if the cppn cannot be compiled
+     */
+    bool initializeSplinesCompiled(std::valarray<double> & splines);
+    
+    /**
+     * Fills the splines of the current individual with a BatchedNetwork, evaluating
+     * all the samples of a module at once
+     *
+     * @return false, without changing splines, if the cppn cannot be batched
+     */
+    bool initializeSplinesBatched(std::valarray<double> & splines);
+    
     /**
 	 * Creates a model genome made only of node genes
      *
@@ -121,6 +141,8 @@ private:
     
     Population population;
     CPPN cppn;
+    
+    std::string CPPN_EVALUATOR = ParametersReader::get<std::string>("CPPN_EVALUATOR");
 };
 
 #endif
@@ -150,24 +150,33 @@ void SplineNeat::initializePolicy(){
     // Create a valarray of numSplines row of size values
     std::valarray<double> splines(numSplines * splineLength);
     
-    // For each module
-    for ( std::size_t i=0; i < numSplines; i++ ) {
-        // set the X and Y positions on the cppn
-        int x = modulePositions[i].x;
-        int y = modulePositions[i].y;
-        cppn.setValue("Bias", 0.3);
-        cppn.setValue("X", x);
-        cppn.setValue("Y", y);
-        for ( unsigned int j = 0; j < splineLength; j++ ) {
-            // set the 'time' value on the cppn
-            cppn.setValue("T", interval[j]);
+    bool initialized = false;
+    if (CPPN_EVALUATOR == "BATCHED") {
+        initialized = initializeSplinesBatched(splines);
+    } else if (CPPN_EVALUATOR == "COMPILED") {
+        initialized = initializeSplinesCompiled(splines);
+    }
+    
+    if (!initialized) {
+        // For each module
+        for ( std::size_t i=0; i < numSplines; i++ ) {
+            // set the X and Y positions on the cppn
+            int x = modulePositions[i].x;
+            int y = modulePositions[i].y;
+            cppn.setValue("Bias", 0.3);
+            cppn.setValue("X", x);
+            cppn.setValue("Y", y);
+            for ( unsigned int j = 0; j < splineLength; j++ ) {
+                // set the 'time' value on the cppn
+                cppn.setValue("T", interval[j]);
             
-            // calculate the next output
-            cppn.update();
+                // calculate the next output
+                cppn.update();
             
-            splines[ i*splineLength + j ] = 0.5 * (cppn.getValue("Output_Y") + 1);
+                splines[ i*splineLength + j ] = 0.5 * (cppn.getValue("Output_Y") + 1);
+            }
+            cppn.reinitialize();
         }
-        cppn.reinitialize();
     }
     
     // Convert the valarray to a Values class that Policy uses
@@ -177,6 +186,66 @@ void SplineNeat::initializePolicy(){
     currentPolicy = new POWER::Policy(currentIndividual, 0, interval, parameters);
 }
 
+bool SplineNeat::initializeSplinesCompiled(std::valarray<double> & splines){
+    CompiledNetwork compiledCppn(population.getIndividual(currentIndividual, currentGeneration));
+    if (!compiledCppn.isCompiled()) {
+        return false;
+    }
+    
+    int bias = compiledCppn.getSlot("Bias");
+    int xInput = compiledCppn.getSlot("X");
+    int yInput = compiledCppn.getSlot("Y");
+    int tInput = compiledCppn.getSlot("T");
+    int output = compiledCppn.getSlot("Output_Y");
+    
+    std::size_t splineLength = interval.size();
+    for ( std::size_t i=0; i < numSplines; i++ ) {
+        int x = modulePositions[i].x;
+        int y = modulePositions[i].y;
+        compiledCppn.setValue(bias, 0.3);
+        compiledCppn.setValue(xInput, x);
+        compiledCppn.setValue(yInput, y);
+        for ( unsigned int j = 0; j < splineLength; j++ ) {
+            compiledCppn.setValue(tInput, interval[j]);
+            compiledCppn.update();
+            splines[ i*splineLength + j ] = 0.5 * (compiledCppn.getValue(output) + 1);
+        }
+        compiledCppn.reinitialize();
+    }
+    
+    return true;
+}
+
+bool SplineNeat::initializeSplinesBatched(std::valarray<double> & splines){
+    BatchedNetwork batchedCppn(population.getIndividual(currentIndividual, currentGeneration));
+    if (!batchedCppn.isBatchable()) {
+        return false;
+    }
+    
+    std::size_t splineLength = interval.size();
+    std::vector<double> times(splineLength);
+    for ( unsigned int j = 0; j < splineLength; j++ ) {
+        times[j] = interval[j];
+    }
+    batchedCppn.setValues("T", times);
+    
+    // For each module, evaluate all the samples of its splines at once
+    for ( std::size_t i=0; i < numSplines; i++ ) {
+        int x = modulePositions[i].x;
+        int y = modulePositions[i].y;
+        batchedCppn.setValue("Bias", 0.3);
+        batchedCppn.setValue("X", x);
+        batchedCppn.setValue("Y", y);
+        batchedCppn.update(splineLength);
+        for ( unsigned int j = 0; j < splineLength; j++ ) {
+            splines[ i*splineLength + j ] = 0.5 * (batchedCppn.getValue("Output_Y", j) + 1);
+        }
+        batchedCppn.reinitialize();
+    }
+    
+    return true;
+}
+
 /**
  * Creates a model genome made only of node genes
  * @param hiddenLayers - the number of hidden layers
@@ -8,7 +8,6 @@
 
 #include "MatingStrategy.h"
 #include "ProximityMating.h"
-#include "MessagesManager.h"
 
 MatingStrategy::MatingStrategy(WorldModel &wm, MessageHandler &mh,MessageHandler &emh) :
 worldModel(wm),
@@ -48,17 +47,17 @@ void MatingStrategy::sendCoupleMessage(id_t mateId) {
     int mateIndex = searchForOrganism(mateId);
     
     if(mateIndex >= 0) {
-        std::string message = "[COUPLE_MESSAGE]";
+        Message message(COUPLE_MESSAGE);
         
-        message = MessagesManager::add(message, "ID1", std::to_string(worldModel.organismId));
-        message = MessagesManager::add(message, "FITNESS1", std::to_string(worldModel.adultFitness));
-        message = MessagesManager::add(message, "GENOME1", worldModel.bodyGenome);
-        message = MessagesManager::add(message, "MIND1", worldModel.mindGenome);
+        message.add("ID1", std::to_string(worldModel.organismId));
+        message.add("FITNESS1", std::to_string(worldModel.adultFitness));
+        worldModel.genomeStore.addFull(message, "GENOME1", worldModel.bodyGenome);
+        worldModel.genomeStore.addFull(message, "MIND1", worldModel.mindGenome);
         
-        message = MessagesManager::add(message, "ID2", std::to_string(mateId));
-        message = MessagesManager::add(message, "FITNESS2", std::to_string(organismsToMateWith[mateIndex].getFitness()));
-        message = MessagesManager::add(message, "GENOME2", organismsToMateWith[mateIndex].getGenome());
-        message = MessagesManager::add(message, "MIND2", organismsToMateWith[mateIndex].getMind());
+        message.add("ID2", std::to_string(mateId));
+        message.add("FITNESS2", std::to_string(organismsToMateWith[mateIndex].getFitness()));
+        worldModel.genomeStore.addFull(message, "GENOME2", organismsToMateWith[mateIndex].getGenome());
+        worldModel.genomeStore.addFull(message, "MIND2", organismsToMateWith[mateIndex].getMind());
         
         evolverMessageHandler.send(message);
     } else {
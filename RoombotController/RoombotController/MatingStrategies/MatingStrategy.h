@@ -13,6 +13,7 @@
 #include "Organism.h"
 #include "MessageHandler.h"
 #include "ParentSelectionMechanism.h"
+#include "ParametersReader.h"
 #include "Logger.h"
 
 class MatingStrategy {
@@ -38,6 +39,8 @@ protected:
     
     int searchForOrganism(id_t organismId);
     
+    int GENOME_EXCHANGE_CHANNEL = ParametersReader::get<int>("GENOME_EXCHANGE_CHANNEL");
+    
     WorldModel &worldModel;
     MessageHandler &messageHandler;
     MessageHandler &evolverMessageHandler;
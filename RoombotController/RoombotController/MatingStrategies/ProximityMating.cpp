@@ -7,7 +7,6 @@
 //
 
 #include "ProximityMating.h"
-#include "MessagesManager.h"
 
 ProximityMating::ProximityMating(WorldModel &worldModel, MessageHandler &messageHandler, MessageHandler &evolverMessageHandler) : MatingStrategy(worldModel, messageHandler, evolverMessageHandler) {
     lastFitnessSent = 0;
@@ -40,16 +39,37 @@ void ProximityMating::mate() {
 
 void ProximityMating::receiveGenomes() {
     while (messageHandler.hasMessage()) {
-        std::string message = messageHandler.receive();
+        MessageView message = messageHandler.receiveView();
         
-        if (message.substr(0,23).compare("[GENOME_SPREAD_MESSAGE]") == 0) {
-            id_t mateId;
-            double mateFitness;
-            std::string mateGenome;
-            std::string mateMind;
-            readMateMessage(message, mateId, mateFitness, mateGenome, mateMind);
+        if (message.getType() == GENOME_SPREAD_MESSAGE) {
+            id_t mateId = message.getLong("ID");
+            double mateFitness = message.getDouble("FITNESS");
             
-            updateOrganismsToMateWithList(mateId, mateFitness, mateGenome, mateMind);
+            if (searchForOrganism(mateId) >= 0) {
+                // genomes of a known mate do not change, only its fitness does
+                updateOrganismsToMateWithList(mateId, mateFitness, std::string(), std::string());
+            } else {
+                std::string mateGenome;
+                std::string mateMind;
+                std::string missingDigest;
+                if (readMateGenomes(message, mateGenome, mateMind, missingDigest)) {
+                    updateOrganismsToMateWithList(mateId, mateFitness, mateGenome, mateMind);
+                } else {
+                    // we missed the broadcast with the full genome, ask its owner for it
+                    Message request = GenomeStore::createRequest(missingDigest);
+                    request.add("ID", std::to_string(mateId));
+                    messageHandler.send(request);
+                }
+            }
+        } else if (message.getType() == GENOME_REQUEST_MESSAGE) {
+            if (message.getLong("ID") == worldModel.organismId) {
+                Message content = worldModel.genomeStore.createContent(message.get("DIGEST"));
+                if (content.getType() == GENOME_CONTENT_MESSAGE) {
+                    messageHandler.send(content);
+                }
+            }
+        } else if (message.getType() == GENOME_CONTENT_MESSAGE) {
+            worldModel.genomeStore.put(message.get("DIGEST"), message.get("CONTENT"));
         }
         
         messageHandler.next();
@@ -59,12 +79,12 @@ void ProximityMating::receiveGenomes() {
 void ProximityMating::broadcastGenome() {
     if (worldModel.now - lastFitnessSent > SPREAD_FITNESS_INTERVAL)
     {
-        // spread genome and fitness
-        std::string genomeMessage = "[GENOME_SPREAD_MESSAGE]";
-        genomeMessage = MessagesManager::add(genomeMessage, "ID", std::to_string(worldModel.organismId));
-        genomeMessage = MessagesManager::add(genomeMessage, "FITNESS", std::to_string(worldModel.adultFitness));
-        genomeMessage = MessagesManager::add(genomeMessage, "GENOME", worldModel.bodyGenome);
-        genomeMessage = MessagesManager::add(genomeMessage, "MIND", worldModel.mindGenome);
+        // spread genome and fitness, genomes are sent in full only the first time
+        Message genomeMessage(GENOME_SPREAD_MESSAGE);
+        genomeMessage.add("ID", std::to_string(worldModel.organismId));
+        genomeMessage.add("FITNESS", std::to_string(worldModel.adultFitness));
+        worldModel.genomeStore.add(genomeMessage, "GENOME", worldModel.bodyGenome, GENOME_EXCHANGE_CHANNEL);
+        worldModel.genomeStore.add(genomeMessage, "MIND", worldModel.mindGenome, GENOME_EXCHANGE_CHANNEL);
         
         messageHandler.send(genomeMessage);
         
@@ -72,11 +92,9 @@ void ProximityMating::broadcastGenome() {
     }
 }
 
-void ProximityMating::readMateMessage(std::string message, id_t &mateId, double &mateFitness, std::string &mateGenome, std::string &mateMind) {
-    mateId = std::atoi(MessagesManager::get(message, "ID").c_str());
-    mateFitness = std::atof(MessagesManager::get(message, "FITNESS").c_str());
-    mateGenome = MessagesManager::get(message, "GENOME");
-    mateMind = MessagesManager::get(message, "MIND");
+bool ProximityMating::readMateGenomes(const MessageView & message, std::string &mateGenome, std::string &mateMind, std::string &missingDigest) {
+    return worldModel.genomeStore.resolve(message, "GENOME", &mateGenome, &missingDigest) &&
+        worldModel.genomeStore.resolve(message, "MIND", &mateMind, &missingDigest);
 }
 
 void ProximityMating::updateOrganismsToMateWithList(id_t mateId, double mateFitness, std::string mateGenome, std::string mateMind)
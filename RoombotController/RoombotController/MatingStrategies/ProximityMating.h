@@ -11,10 +11,11 @@
 
 #include "MatingStrategy.h"
 #include "MessageHandler.h"
+#include "MessageView.h"
 
 class ProximityMating : public MatingStrategy {
 public:
-    double SPREAD_FITNESS_INTERVAL;
+    double SPREAD_FITNESS_INTERVAL = ParametersReader::get<double>("SPREAD_FITNESS_INTERVAL");
     
     ProximityMating(WorldModel &worldModel, MessageHandler &messageHandler, MessageHandler &evolverMessageHandler);
     
@@ -22,7 +23,7 @@ public:
     virtual void mate();
     
 private:
-    void readMateMessage(std::string message, id_t &mateId, double &mateFitness, std::string &mateGenome, std::string &mateMind);
+    bool readMateGenomes(const MessageView & message, std::string &mateGenome, std::string &mateMind, std::string &missingDigest);
     void updateOrganismsToMateWithList(id_t mateId, double mateFitness, std::string mateGenome, std::string mateMind);
     void broadcastGenome();
     void receiveGenomes();
@@ -45,7 +45,7 @@ void MovementController::initialise() {
 void MovementController::step() {
     if(worldModel.iAmRoot()) {
 //        logger.debugStream() << worldModel.now << " " << worldModel.robotName << " stepping movement controller";
-        currentPositions = receiveAngles();     // read current angles
+        receiveAngles(currentPositions);        // read current angles
         
         // Set the angles for the root module with the ones at time T-1
         for(size_t i=0;i<motors.size();i++) {
@@ -65,15 +65,15 @@ void MovementController::step() {
         
         learningController->step();
     } else {
-        dvector currentPositions = dvector(motors.size(),0.0);
+        moduleAngles.resize(motors.size());
         for(size_t i=0;i<motors.size();i++) {
-            currentPositions[i] = getMotorPosition(i);
+            moduleAngles[i] = getMotorPosition(i);
         }
-        sendAngles(worldModel.robotIndex,currentPositions);         // send angles using emitter
+        sendAngles(worldModel.robotIndex,moduleAngles);         // send angles using emitter
         
-        dvector nextAngles = receiveAngles(worldModel.robotIndex);
+        receiveAngles(worldModel.robotIndex,nextModuleAngles);
         for(size_t i=0;i<motors.size();i++) {
-            setMotorPosition(i,nextAngles[i]);
+            setMotorPosition(i,nextModuleAngles[i]);
         }
 
     }
@@ -133,100 +133,52 @@ void MovementController::normaliseMotors() {
 }
 
 // use the emitter to send motors' angles
-void MovementController::sendAngles(doubledvector next){
+void MovementController::sendAngles(const doubledvector & next){
     if(next.size() > 0){
-        using namespace boost::property_tree;
-        ptree data;
-        data.put("type","command");
-        data.put("timestamp",worldModel.now);
-        for(int i=0;i<next.size();i++){
-            ptree sub;
-            for(int j=0;j<next[i].size();j++){
-                sub.put(std::to_string(j),next[i][j]);
-            }
-            data.add_child(std::to_string(i), sub);
-        }
-        
-        std::ostringstream datastring;
-        boost::property_tree::json_parser::write_json(datastring,data,false);
-
-        messageHandler.send(datastring.str());
+        size_t size = AngleFrame::encodeCommand(frameBuffer, worldModel.now, next);
+        messageHandler.send(frameBuffer.data(), size);
     }
 }
 
 // send angles using emitter
-void MovementController::sendAngles(size_t index, dvector current){
+void MovementController::sendAngles(size_t index, const dvector & current){
     if(current.size() > 0){
-        using namespace boost::property_tree;
-        ptree data;
-        data.put("type","inform");
-        data.put("index",std::to_string(index));
-        data.put("timestamp",worldModel.now);
-        for(int j=0;j<current.size();j++){
-            data.put(std::to_string(j),current[j]);
-        }
-        
-        std::ostringstream datastring;
-        boost::property_tree::json_parser::write_json(datastring,data,false);
-//        logger.debugStream() << "[" << worldModel.now << "] sendAngles(index) " << worldModel.robotName << " sending data: " << datastring.str();
-        messageHandler.send(datastring.str());
+        size_t size = AngleFrame::encodeInform(frameBuffer, worldModel.now, index, current);
+        messageHandler.send(frameBuffer.data(), size);
     }
 }
 
 // get the angles for each motors of each module of the organisms
-doubledvector MovementController::receiveAngles()
+void MovementController::receiveAngles(doubledvector & result)
 {
-    doubledvector result(worldModel.organismSize,dvector(worldModel.numMotors,0.0));
+    result.resize(worldModel.organismSize);
+    for(size_t i=0;i<result.size();i++){
+        result[i].assign(worldModel.numMotors,0.0);
+    }
     
     while(messageHandler.hasMessage()){
-//        logger.debugStream() << "[" << worldModel.now << "] receiveAngles " << worldModel.robotName << ":" << worldModel.moduleName;
-        using namespace boost::property_tree;
-        ptree data;
-        std::istringstream stream(messageHandler.receive());
-        boost::property_tree::json_parser::read_json(stream, data);
-        
-//        logger.debugStream() << "[" << worldModel.now << "] receiveAngles " << worldModel.robotName << ":" << worldModel.moduleName << ": received data: " << stream.str();
+        boost::string_ref data = messageHandler.receiveData();
+        AngleFrame frame(data.data(), data.size());
         
-        std::string type = data.get<std::string>("type");
-        if(type == "inform") {
-            int index = data.get<double>("index");
-            for(int j=0;j<worldModel.numMotors;j++)
-            {
-                result[index][j] = data.get<double>(std::to_string(j));
-            }
+        if(frame.isValid() && frame.getType() == AngleFrame::INFORM && frame.getModuleIndex() < result.size()) {
+            frame.copyAngles(0, result[frame.getModuleIndex()]);
         }
         
-//        std::cout << "[" << getTime() << "] " << getName() << " received vector with: " << result.size() << " elements" << std::endl;
-//        std::cout << "[" << getTime() << "] " << getName() << " received angles of timestep: " << data.get<double>("timestamp") << std::endl;
-        
         messageHandler.next();
     }
-    
-    return result;
 }
 
 // receive angles using receiver
-dvector MovementController::receiveAngles(size_t index){
-    dvector result(worldModel.numMotors,0.0);
+void MovementController::receiveAngles(size_t index, dvector & result){
+    result.assign(worldModel.numMotors,0.0);
     bool received = false;
     
     while(messageHandler.hasMessage()){
-//        logger.debugStream() << "[" << worldModel.now << "] receiveAngles(index) " << worldModel.robotName << ":" << worldModel.moduleName;
-        
-        using namespace boost::property_tree;
-        std::istringstream stream(messageHandler.receive());
-        ptree data;
-        boost::property_tree::json_parser::read_json(stream, data);
-        
-//        logger.debugStream() << "[" << worldModel.now << "] receiveAngles(index) " << worldModel.robotName << ": received data: " << stream.str();
+        boost::string_ref data = messageHandler.receiveData();
+        AngleFrame frame(data.data(), data.size());
         
-        std::string type = data.get<std::string>("type");
-        if(type == "command") {
-            ptree sub = data.get_child(std::to_string(index));
-            for(int j=0;j<worldModel.numMotors;j++){
-                result[j] = sub.get<double>(std::to_string(j));
-            }
-            
+        if(frame.isValid() && frame.getType() == AngleFrame::COMMAND && index < frame.getModulesCount()) {
+            frame.copyAngles(index, result);
             received = true;
         }
         
@@ -236,7 +188,4 @@ dvector MovementController::receiveAngles(size_t index){
     if(!received) {
         logger.warnStream() << "[" << worldModel.now << "] " << worldModel.robotName << " did not receive any angle updates from root!";
     }
-    
-    
-    return result;
-}
\ No newline at end of file
+}
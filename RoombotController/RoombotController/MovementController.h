@@ -17,6 +17,7 @@
 #include "Logger.h"
 #include "LearningController.h"
 #include "Defines.h"
+#include "AngleFrame.h"
 
 using namespace webots;
 
@@ -46,11 +47,19 @@ public:
     void initialiseMotors();
     void normaliseMotors();
     
-    void sendAngles(doubledvector nextPositions);
-    void sendAngles(size_t index, dvector currentPositions);
+    void sendAngles(const doubledvector & nextPositions);
+    void sendAngles(size_t index, const dvector & currentPositions);
 
-    doubledvector receiveAngles();
-    dvector receiveAngles(size_t index);
+    /**
+     * Reads the angles sent by the other modules into result, one row per module.
+     * Modules that did not send anything have all their angles set to 0.
+     */
+    void receiveAngles(doubledvector & result);
+    
+    /**
+     * Reads the angles the root sent to the module with the given index into result.
+     */
+    void receiveAngles(size_t index, dvector & result);
 private:
     WorldModel &worldModel;
     MessageHandler &messageHandler;
@@ -68,6 +77,10 @@ private:
     dvector anglesTMinusOne;
     dvector anglesTPlusOne;
     
+    dvector moduleAngles;                       // current angles of a non-root module
+    dvector nextModuleAngles;                   // angles received by a non-root module
+    std::vector<char> frameBuffer;              // reused to encode the angle frames
+    
     std::vector<Motor*> motors;
 //    std::vector<PositionSensor*> sensors;       // motor sensors
     double motorRange;                          // range of motors
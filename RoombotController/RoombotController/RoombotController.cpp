@@ -68,9 +68,13 @@ void RoombotController::initialise() {
         learningController = std::unique_ptr<LearningController>(new LearningController(worldModel));
         adultFitnessMeasure = std::unique_ptr<FitnessMeasure>(new SpeedFitness(worldModel));
         
-        Emitter *genomeEmitter = initialiseEmitter(ROOMBOT_GENOME_EMITTER_NAME);
-        Receiver *genomeReceiver = initialiseReceiver(ROOMBOT_GENOME_RECEIVER_NAME);
-        MessageHandler matingMessagesHandler(genomeEmitter,genomeReceiver);
+        RadioEmitter *genomeEmitter = initialiseEmitter(ROOMBOT_GENOME_EMITTER_NAME);
+        RadioReceiver *genomeReceiver = initialiseReceiver(ROOMBOT_GENOME_RECEIVER_NAME);
+        matingMessagesHandler = MessageHandler(genomeEmitter,genomeReceiver);
+        
+        evolverMessageHandler.setTraffic(&traffic);
+        movementMessageHandler.setTraffic(&traffic);
+        matingMessagesHandler.setTraffic(&traffic);
         
         if (matingType == MATING_SELECTION_BY_EVOLVER)
         {
@@ -112,18 +116,19 @@ void RoombotController::initialiseWorldModel() {
 /********************************************* MINOR FUNCTIONS *********************************************/
 
 // emitter initialization
-Emitter * RoombotController::initialiseEmitter(std::string name)
+RadioEmitter * RoombotController::initialiseEmitter(std::string name)
 {
     Emitter * emitter = getEmitter(name);
     if (!emitter) {
         throw std::runtime_error("Device Not Found: "+name);
     }
     
-    return emitter;
+    radioEmitters.push_back(std::unique_ptr<RadioEmitter>(new WebotsEmitter(emitter)));
+    return radioEmitters.back().get();
 }
 
 // receiver initialization
-Receiver * RoombotController::initialiseReceiver(std::string name)
+RadioReceiver * RoombotController::initialiseReceiver(std::string name)
 {
     Receiver * receiver = getReceiver(name);
     if (!receiver) {
@@ -131,7 +136,8 @@ Receiver * RoombotController::initialiseReceiver(std::string name)
     }
     receiver->enable(worldModel.TIME_STEP);
 
-    return receiver;
+    radioReceivers.push_back(std::unique_ptr<RadioReceiver>(new WebotsReceiver(receiver)));
+    return radioReceivers.back().get();
 }
 
 // initialize GPS
@@ -223,29 +229,54 @@ void RoombotController::disableAllConnectors()
 
 void RoombotController::sendAdultAnnouncement()
 {
-    std::string message = "[ADULT_ANNOUNCEMENT]";
-    message = MessagesManager::add(message, "ID", std::to_string(worldModel.organismId));
+    Message message(ADULT_ANNOUNCEMENT);
+    message.add("ID", std::to_string(worldModel.organismId));
     
-    evolverMessageHandler.send(message);
+    evolverMessageHandler.queue(message);
 }
 
 
 void RoombotController::sendFertileAnnouncement()
 {
-    std::string message = "[FERTILE_ANNOUNCEMENT]";
-    message = MessagesManager::add(message, "ID", std::to_string(worldModel.organismId));
+    Message message(FERTILE_ANNOUNCEMENT);
+    message.add("ID", std::to_string(worldModel.organismId));
 
-    evolverMessageHandler.send(message);
+    evolverMessageHandler.queue(message);
 }
 
 
 void RoombotController::sendFitnessUpdateToEvolver(double fitness)
 {
-    std::string message = "[FITNESS_UPDATE]";
-    message = MessagesManager::add(message, "ID", std::to_string(worldModel.organismId));
-    message = MessagesManager::add(message, "FITNESS", std::to_string(fitness));
+    Message message(FITNESS_UPDATE);
+    message.add("ID", std::to_string(worldModel.organismId));
+    message.add("FITNESS", std::to_string(fitness));
     
-    evolverMessageHandler.send(message);
+    evolverMessageHandler.queue(message);
+}
+
+
+// sample the receiver queues of the channels used by the root module
+void RoombotController::countQueueLengths()
+{
+    evolverMessageHandler.countQueueLength();
+    movementMessageHandler.countQueueLength();
+    matingMessagesHandler.countQueueLength();
+}
+
+// consume the death announcements, true if one of them is for this organism
+bool RoombotController::receivedDeathAnnouncement()
+{
+    bool dead = false;
+    std::string organismId = std::to_string(worldModel.organismId);
+    while(deathMessageHandler.hasMessage())
+    {
+        // announcements are sent as text, with their terminating character
+        boost::string_ref message = deathMessageHandler.receiveData();
+        message = message.substr(0, message.find('\0'));
+        dead = dead || message == organismId;
+        deathMessageHandler.next();
+    }
+    return dead;
 }
 
 
@@ -274,7 +305,7 @@ bool RoombotController::checkLocks()
     {
         logger.warnStream() << getName() << " detected connectors problem";
         
-        std::string message = "[CONNECTORS_PROBLEM_MESSAGE]";
+        Message message(CONNECTORS_PROBLEM_MESSAGE);
         movementMessageHandler.send(message);
         return false;
     }
@@ -288,9 +319,9 @@ bool RoombotController::checkLocks()
         
         while (movementMessageHandler.hasMessage())
         {
-            std::string message = movementMessageHandler.receive();
+            MessageView message = movementMessageHandler.receiveView();
             
-            if (message.compare("[CONNECTORS_PROBLEM_MESSAGE]") == 0)
+            if (message.getType() == CONNECTORS_PROBLEM_MESSAGE)
             {
                 logger.debugStream() << getName() << " received connectors problem message";
                 
@@ -298,7 +329,7 @@ bool RoombotController::checkLocks()
                 {
                     logger.debugStream() << getName() << " forwarded connectors problem";
                     
-                    std::string message = "[CONNECTORS_PROBLEM_MESSAGE]";
+                    Message message(CONNECTORS_PROBLEM_MESSAGE);
                     movementMessageHandler.send(message);
                 }
                 return false;
@@ -326,7 +357,7 @@ bool RoombotController::checkFallenInside()
         {
             logger.warnStream() << getName() << " detected fallen into cylinder problem";
             
-            std::string message = "[CYLINDER_PROBLEM_MESSAGE]";
+            Message message(CYLINDER_PROBLEM_MESSAGE);
             movementMessageHandler.send(message);
             return false;
         }
@@ -340,9 +371,9 @@ bool RoombotController::checkFallenInside()
             }
             
             while(movementMessageHandler.hasMessage()) {
-                std::string message = movementMessageHandler.receive();
+                MessageView message = movementMessageHandler.receiveView();
                 
-                if (message.compare("[CYLINDER_PROBLEM_MESSAGE]") == 0) {
+                if (message.getType() == CYLINDER_PROBLEM_MESSAGE) {
                     logger.debugStream() << getName() << " received fallen into cylinder problem";
                     
                     return false;
@@ -361,10 +392,11 @@ void RoombotController::askToBeBuiltAgain()
 {
     evolverMessageHandler.setChannel(CLINIC_CHANNEL);
     
-    std::string message = "[REBUILD_MESSAGE]";
-    message = MessagesManager::add(message, "ID", std::to_string(worldModel.organismId));
-    message = MessagesManager::add(message, "GENOME", worldModel.bodyGenome);
-    message = MessagesManager::add(message, "MIND", worldModel.mindGenome);
+    Message message(REBUILD_MESSAGE);
+    message.add("ID", std::to_string(worldModel.organismId));
+    // in full, since the clinic only keeps the genomes it used recently
+    worldModel.genomeStore.addFull(message, "GENOME", worldModel.bodyGenome);
+    worldModel.genomeStore.addFull(message, "MIND", worldModel.mindGenome);
     
     evolverMessageHandler.send(message);
     evolverMessageHandler.setChannel(EVOLVER_CHANNEL);
@@ -398,6 +430,7 @@ void RoombotController::life()
         double lastFitnessUpdate = 0;
         double lastMating = 0;
         double lastEvolverUpdate = 0;
+        double lastTrafficLogging = 0;
         worldModel.lifetimeStart = getTime();   // remember offset for time calculations
         adultFitnessMeasure->markStart();
         
@@ -416,14 +449,9 @@ void RoombotController::life()
             
             if (deathType == DEATH_SELECTION_BY_EVOLVER)
             {
-                while(deathMessageHandler.hasMessage())
+                if (receivedDeathAnnouncement())
                 {
-                    std::string message = deathMessageHandler.receive();
-                    deathMessageHandler.next();
-                    if (message.compare(std::to_string(worldModel.organismId)) == 0 )
-                    {
-                        return; // end mature life (so die)
-                    }
+                    return; // end mature life (so die)
                 }
             }
             
@@ -516,13 +544,13 @@ void RoombotController::life()
                     if (worldModel.now - lastFitnessSent > SEND_FITNESS_TO_EVOLVER_INTERVAL)
                     {
                         // send genome and fitness to evolver
-                        string message = "[GENOME_SPREAD_MESSAGE]";
-                        message = MessagesManager::add(message, "ID", std::to_string(worldModel.organismId));
-                        message = MessagesManager::add(message, "FITNESS", std::to_string(worldModel.adultFitness));
-                        message = MessagesManager::add(message, "GENOME", worldModel.bodyGenome);
-                        message = MessagesManager::add(message, "MIND", worldModel.mindGenome);
+                        Message message(GENOME_SPREAD_MESSAGE);
+                        message.add("ID", std::to_string(worldModel.organismId));
+                        message.add("FITNESS", std::to_string(worldModel.adultFitness));
+                        worldModel.genomeStore.addFull(message, "GENOME", worldModel.bodyGenome);
+                        worldModel.genomeStore.addFull(message, "MIND", worldModel.mindGenome);
                         
-                        evolverMessageHandler.send(message);
+                        evolverMessageHandler.queue(message);
                         
                         // store in file
                         storeMatureLifeFitnessIntoFile(worldModel.adultFitness);
@@ -549,6 +577,21 @@ void RoombotController::life()
              *** STEP MOTORS ***
              *******************/
             movementController->step();
+            
+            /************************************************
+             ***** SEND STATUS UPDATES QUEUED THIS STEP *****
+             ************************************************/
+            evolverMessageHandler.flush();
+            
+            /**************************************
+             ***** LOG TRAFFIC OF THE CHANNELS *****
+             **************************************/
+            countQueueLengths();
+            if (worldModel.now - lastTrafficLogging > TRAFFIC_LOGGING_INTERVAL)
+            {
+                traffic.store(RESULTS_PATH + worldModel.simulationDateAndTime + "/traffic.txt", worldModel.robotName, getTime());
+                lastTrafficLogging = worldModel.now;
+            }
         } // while
         
         learningController->finalise();
@@ -579,14 +622,9 @@ void RoombotController::life()
             
             if (deathType == DEATH_SELECTION_BY_EVOLVER)
             {
-                while(deathMessageHandler.hasMessage())
+                if (receivedDeathAnnouncement())
                 {
-                    std::string message = deathMessageHandler.receive();
-                    deathMessageHandler.next();
-                    if (message.compare(std::to_string(worldModel.organismId)) == 0 )
-                    {
-                        return; // end mature life (so die)
-                    }
+                    return; // end mature life (so die)
                 }
             }
             
@@ -632,14 +670,14 @@ void RoombotController::death()
         }
     }
     
-    std::string message = "[DEATH_ANNOUNCEMENT_MESSAGE]";
-    message = MessagesManager::add(message, "ID", std::to_string(worldModel.organismId));
+    Message message(DEATH_ANNOUNCEMENT_MESSAGE);
+    message.add("ID", std::to_string(worldModel.organismId));
     evolverMessageHandler.send(message);
     
     evolverMessageHandler.setChannel(MODIFIER_CHANNEL);
-    message = "[TO_RESERVE_MESSAGE]";
-    message = MessagesManager::add(message, "NAME", getName());
-    evolverMessageHandler.send(message);
+    Message reserveMessage(TO_RESERVE_MESSAGE);
+    reserveMessage.add("NAME", getName());
+    evolverMessageHandler.send(reserveMessage);
     
     while (true) {
         movementController->normaliseMotors();
@@ -4,7 +4,6 @@
 #include "Organism.h"
 #include "Defines.h"
 #include "ParametersReader.h"
-#include "MessagesManager.h"
 #include "MessageHandler.h"
 #include "ParentSelectionMechanism.h"
 #include "BestTwoParentSelection.h"
@@ -13,6 +12,7 @@
 #include "WorldModel.h"
 #include "MatingStrategy.h"
 #include "MessageHandler.h"
+#include "WebotsRadio.h"
 #include "Logger.h"
 
 #include "LearningAlgorithm.h"
@@ -66,6 +66,7 @@ private:
     int ROOMBOT_WAITING_TIME = ParametersReader::get<int>("ROOMBOT_WAITING_TIME");
     int UPDATE_FITNESS_IN_EVOLVER = ParametersReader::get<int>("MATING_TIME");      // FOR DISTRIBUTED REPRODUCTION
     int UPDATE_FITNESS_INTERVAL = ParametersReader::get<int>("UPDATE_FITNESS_INTERVAL");
+    double TRAFFIC_LOGGING_INTERVAL = ParametersReader::get<double>("TRAFFIC_LOGGING_INTERVAL");
     
     double FERTILITY_DISTANCE = ParametersReader::get<double>("FERTILITY_DISTANCE");   
     
@@ -85,9 +86,15 @@ private:
     
     std::unique_ptr<MatingStrategy> matingStrategy;
     
+    std::vector<std::unique_ptr<RadioEmitter> > radioEmitters;      // devices used by the message handlers
+    std::vector<std::unique_ptr<RadioReceiver> > radioReceivers;
+    
     MessageHandler evolverMessageHandler;
     MessageHandler movementMessageHandler;
     MessageHandler deathMessageHandler;
+    MessageHandler matingMessagesHandler;
+    
+    ChannelTraffic traffic;                    // counted by the root module only
     
     GPS * gps;                                 // GPS
     
@@ -98,8 +105,8 @@ private:
     void initialiseWorldModel();
     
     Emitter * _init_emitter_clinic(int);
-    Emitter * initialiseEmitter(std::string name);
-    Receiver * initialiseReceiver(std::string name);
+    RadioEmitter * initialiseEmitter(std::string name);
+    RadioReceiver * initialiseReceiver(std::string name);
     
     GPS * initialiseGPS(double);
 
@@ -149,6 +156,10 @@ private:
     void sendFertileAnnouncement();
     
     void sendFitnessUpdateToEvolver(double fitness);
+    
+    bool receivedDeathAnnouncement();
+    
+    void countQueueLengths();
 };
 
 #endif	/* ROOMBOT_CONTROLLER_H */
\ No newline at end of file
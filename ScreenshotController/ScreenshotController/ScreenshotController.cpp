@@ -22,11 +22,11 @@ void ScreenshotController::run()
     {
         if(receiver->getQueueLength() > 0)
         {
-            std::string message = (char*)receiver->getData();
-            if (message.substr(0,24).compare("[ENVIRONMENT_OK_MESSAGE]") == 0)
+            Message message = Message::decode(receiver->getData(), receiver->getDataSize());
+            if (message.getType() == ENVIRONMENT_OK_MESSAGE)
             {
                 environmentOk = true;
-                simulationDateAndTime = MessagesManager::get(message, "SDAT");
+                simulationDateAndTime = message.get("SDAT");
             }
             receiver->nextPacket();
         }
@@ -72,11 +72,11 @@ void ScreenshotController::run()
         
         while(receiver->getQueueLength() > 0)
         {
-            std::string message = (char*)receiver->getData();
+            Message message = Message::decode(receiver->getData(), receiver->getDataSize());
             
-            if (message.substr(0,24).compare("[ORGANISM_BUILT_MESSAGE]") == 0)
+            if (message.getType() == ORGANISM_BUILT_MESSAGE)
             {
-                organismId = std::atoi(MessagesManager::get(message, "ORGANISM_ID").c_str());
+                organismId = std::atoi(message.get("ORGANISM_ID").c_str());
                 takeOrganismScreenshot = true;
             }
             
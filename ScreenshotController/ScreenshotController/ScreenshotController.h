@@ -19,7 +19,7 @@
 
 #include "Defines.h"
 #include "ParametersReader.h"
-#include "MessagesManager.h"
+#include "Message.h"
 
 using namespace webots;
 
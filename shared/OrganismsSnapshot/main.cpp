@@ -0,0 +1,70 @@
+//
+//  main.cpp
+//  OrganismsSnapshot
+//
+//  Prints the live organisms of the evolver at the given times of an experiment,
+//  rebuilt from the organisms_delta.txt file in its results directory.
+//
+//  usage: OrganismsSnapshot organisms_delta.txt [time ...]
+//
+//  Without times, the organisms at the end of the file are printed.
+//
+
+#include "OrganismsHistory.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+
+int main(int argc, const char * argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " organisms_delta.txt [time ...]" << std::endl;
+        return 1;
+    }
+    
+    std::ifstream file(argv[1]);
+    if (!file.good())
+    {
+        std::cerr << "cannot read " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<OrganismsHistory::Change> changes = OrganismsHistory::read(file);
+    
+    std::vector<double> times;
+    for (int i = 2; i < argc; i++)
+    {
+        times.push_back(std::atof(argv[i]));
+    }
+    if (times.empty())
+    {
+        times.push_back(std::numeric_limits<double>::max());
+    }
+    
+    OrganismsHistory history;
+    for (size_t i = 0; i < times.size(); i++)
+    {
+        if (i > 0 && times[i] < times[i - 1])
+        {
+            // changes cannot be undone, start again from the beginning
+            history = OrganismsHistory();
+        }
+        history.applyUntil(changes, times[i]);
+        
+        if (times[i] == std::numeric_limits<double>::max())
+        {
+            std::cout << "#end: ";
+        }
+        else
+        {
+            std::cout << "#time " << times[i] << ": ";
+        }
+        std::cout << history.getOrganisms().size() << " organisms" << std::endl;
+        std::cout << "#position id state" << std::endl;
+        std::cout << history.toString() << std::endl;
+    }
+    return 0;
+}
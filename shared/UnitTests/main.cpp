@@ -10,11 +10,33 @@
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <random>
 #include <map>
+#include <chrono>
+#include <limits>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/filesystem.hpp>
 #include "NEAT.h"
 #include "gtest/gtest.h"
 #include "MatrixGenome.h"
 #include "MatrixGenomeManager.h"
 #include "Logger.h"
+#include "Message.h"
+#include "MessageView.h"
+#include "MessageDispatcher.h"
+#include "AngleFrame.h"
+#include "GenomeStore.h"
+#include "ChannelTraffic.h"
+#include "LocalRadio.h"
+#include "OrganismRegistry.h"
+#include "OrganismsHistory.h"
+#include "LruCache.h"
+#include "WorkerPool.h"
+#include "EventJournal.h"
+#include "Builder.h"
+#include "BatchedNetwork.h"
+#include "CompiledNetwork.h"
+#include "WorldModel.h"
+#include "ProximityMating.h"
 
 
 /*********************************************************/
@@ -95,6 +117,1629 @@ TEST(MatrixGenomeManager, ReadString) {
     ASSERT_EQ(genomes.size(),2);
 }
 
+TEST(Message, EncodeDecode) {
+    Message message(COUPLE_MESSAGE);
+    message.add("ID1", "12").add("GENOME1", std::string("genome\0*ID1 with markers", 24));
+    
+    std::string data = message.encode();
+    Message decoded = Message::decode(data.data(), data.size());
+    
+    ASSERT_EQ(COUPLE_MESSAGE, decoded.getType());
+    ASSERT_FALSE(decoded.isLegacy());
+    ASSERT_EQ("12", decoded.get("ID1"));
+    ASSERT_EQ(std::string("genome\0*ID1 with markers", 24), decoded.get("GENOME1"));
+    ASSERT_FALSE(decoded.has("MIND1"));
+}
+
+TEST(Message, ViewWithoutCopy) {
+    Message message(FITNESS_UPDATE);
+    message.add("ID", "42").add("FITNESS", "0.5");
+    std::string data = message.encode();
+    
+    MessageView view(data.data(), data.size());
+    
+    ASSERT_EQ(FITNESS_UPDATE, view.getType());
+    ASSERT_EQ(2, view.getFieldsCount());
+    ASSERT_EQ(42, view.getLong("ID"));
+    ASSERT_DOUBLE_EQ(0.5, view.getDouble("FITNESS"));
+    ASSERT_TRUE(view.get("ID").data() >= data.data() && view.get("ID").data() < data.data() + data.size());
+    ASSERT_TRUE(view.get("MIND").empty());
+}
+
+TEST(Message, Dispatch) {
+    MessageDispatcher dispatcher;
+    int adults = 0;
+    dispatcher.registerHandler(ADULT_ANNOUNCEMENT, [&adults](const MessageView & message) {
+        adults++;
+        return true;
+    });
+    dispatcher.registerHandler(REBUILD_MESSAGE, [](const MessageView & message) {
+        return false;
+    });
+    
+    std::string adult = Message(ADULT_ANNOUNCEMENT).add("ID", "1").encode();
+    std::string rebuild = Message(REBUILD_MESSAGE).encode();
+    std::string legacyAdult = "[ADULT_ANNOUNCEMENT]*ID2ID*";
+    
+    ASSERT_TRUE(dispatcher.dispatch(MessageView(adult.data(), adult.size())));
+    ASSERT_TRUE(dispatcher.dispatch(MessageView(legacyAdult.c_str(), legacyAdult.length()+1)));
+    ASSERT_FALSE(dispatcher.dispatch(MessageView(rebuild.data(), rebuild.size())));
+    ASSERT_TRUE(dispatcher.dispatch(MessageView(NULL, 0)));
+    
+    ASSERT_EQ(2, adults);
+    ASSERT_EQ(2, dispatcher.getCount(ADULT_ANNOUNCEMENT));
+    ASSERT_EQ(1, dispatcher.getCount(REBUILD_MESSAGE));
+    ASSERT_EQ(1, dispatcher.getCount(UNKNOWN_MESSAGE));
+}
+
+TEST(Message, DispatchBatch) {
+    MessageDispatcher dispatcher;
+    std::vector<std::string> received;
+    MessageDispatcher::Handler record = [&received](const MessageView & message) {
+        received.push_back(Message::getTypeTag(message.getType()) + message.get("ID").to_string());
+        return true;
+    };
+    dispatcher.registerHandler(ADULT_ANNOUNCEMENT, record);
+    dispatcher.registerHandler(FITNESS_UPDATE, record);
+    
+    Message batch(BATCH_MESSAGE);
+    batch.add("RECORD", Message(ADULT_ANNOUNCEMENT).add("ID", "1").encode());
+    batch.add("RECORD", Message(FITNESS_UPDATE).add("ID", "2").add("FITNESS", "0.5").encode());
+    batch.add("RECORD", Message(ADULT_ANNOUNCEMENT).add("ID", "3").encode());
+    std::string data = batch.encode();
+    
+    ASSERT_TRUE(dispatcher.dispatch(MessageView(data.data(), data.size())));
+    ASSERT_EQ(3, received.size());
+    ASSERT_EQ("[ADULT_ANNOUNCEMENT]1", received[0]);
+    ASSERT_EQ("[FITNESS_UPDATE]2", received[1]);
+    ASSERT_EQ("[ADULT_ANNOUNCEMENT]3", received[2]);
+    ASSERT_EQ(1, dispatcher.getCount(BATCH_MESSAGE));
+    ASSERT_EQ(2, dispatcher.getCount(ADULT_ANNOUNCEMENT));
+}
+
+TEST(Message, DispatchNestedBatch) {
+    MessageDispatcher dispatcher;
+    std::vector<std::string> received;
+    dispatcher.registerHandler(ADULT_ANNOUNCEMENT, [&received](const MessageView & message) {
+        received.push_back(message.get("ID").to_string());
+        return true;
+    });
+    
+    Message nested(BATCH_MESSAGE);
+    nested.add("RECORD", Message(ADULT_ANNOUNCEMENT).add("ID", "2").encode());
+    nested.add("RECORD", Message(ADULT_ANNOUNCEMENT).add("ID", "3").encode());
+    Message batch(BATCH_MESSAGE);
+    batch.add("RECORD", Message(ADULT_ANNOUNCEMENT).add("ID", "1").encode());
+    batch.add("RECORD", nested.encode());
+    batch.add("RECORD", Message(ADULT_ANNOUNCEMENT).add("ID", "4").encode());
+    std::string data = batch.encode();
+    
+    // the records of the nested batch are dropped, the ones around it are still handled
+    ASSERT_TRUE(dispatcher.dispatch(MessageView(data.data(), data.size())));
+    ASSERT_EQ(2, received.size());
+    ASSERT_EQ("1", received[0]);
+    ASSERT_EQ("4", received[1]);
+    ASSERT_EQ(2, dispatcher.getCount(BATCH_MESSAGE));
+    ASSERT_EQ(2, dispatcher.getCount(ADULT_ANNOUNCEMENT));
+}
+
+TEST(Message, DecodeLegacy) {
+    std::string data = "[FITNESS_UPDATE]*ID42ID**FITNESS0.5FITNESS*";
+    Message decoded = Message::decode(data.c_str(), data.length()+1);
+    
+    ASSERT_EQ(FITNESS_UPDATE, decoded.getType());
+    ASSERT_TRUE(decoded.isLegacy());
+    ASSERT_EQ("42", decoded.get("ID"));
+    ASSERT_EQ("0.5", decoded.get("FITNESS"));
+    ASSERT_EQ(data, decoded.toString());
+}
+
+TEST(Message, DecodeTruncated) {
+    Message message(ADULT_ANNOUNCEMENT);
+    message.add("ID", "7");
+    std::string data = message.encode();
+    
+    Message decoded = Message::decode(data.data(), data.size()-1);
+    ASSERT_EQ(UNKNOWN_MESSAGE, decoded.getType());
+}
+
+TEST(Message, Compressed) {
+    std::string genome;
+    for (int i = 0; i < 200; i++) {
+        genome += "0.5 -0.25 1 ";
+    }
+    Message message(GENOME_SPREAD_MESSAGE);
+    message.add("ID", "3").add("GENOME", genome);
+    std::string data = message.encode();
+    ASSERT_TRUE(data[5] & Message::FLAG_COMPRESSED);
+    ASSERT_LT(data.size(), genome.size() / 4);
+    
+    MessageView view(data.data(), data.size());
+    MessageView copy = view;
+    ASSERT_EQ(GENOME_SPREAD_MESSAGE, copy.getType());
+    ASSERT_EQ(3, copy.getLong("ID"));
+    ASSERT_EQ(genome, copy.get("GENOME").to_string());
+    ASSERT_EQ(UNKNOWN_MESSAGE, MessageView(data.data(), data.size() - 1).getType());
+    
+    // a corrupt inflated size, far above any message, is rejected before allocating
+    std::string corrupt = data;
+    corrupt[Message::WIRE_HEADER_SIZE + 3] = '\xff';
+    ASSERT_EQ(UNKNOWN_MESSAGE, MessageView(corrupt.data(), corrupt.size()).getType());
+    
+    Message::setCompressionThreshold(GENOME_SPREAD_MESSAGE, 0);
+    ASSERT_FALSE(message.encode()[5] & Message::FLAG_COMPRESSED);
+    Message::setCompressionThreshold(GENOME_SPREAD_MESSAGE, Message::DEFAULT_COMPRESSION_THRESHOLD);
+}
+
+/**
+ * A GENOME_SPREAD_MESSAGE carrying a body genome shaped like the lines of genomes.txt (CppnGenome::toString)
+ * and a mind genome like those of mind_genomes.txt is compressed to less than half its size and decoded
+ * unchanged. The bytes on the wire and the encoding plus decoding time are printed.
+ */
+TEST(Message, CompressedGenomeSpread) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> weight(-3, 3);
+    
+    std::ostringstream body;
+    body << "genome 12 cppn " << 8 + 40 << " ";
+    const char * functions[] = { "NEAT_SIGMOID", "NEAT_SIN", "NEAT_GAUSSIAN", "NEAT_LINEAR" };
+    for (int i = 0; i < 8; i++) {
+        body << "NodeGene " << i << " 1 Input" << i << " NetworkSensor NEAT_LINEAR 0 0 ";
+    }
+    for (int i = 0; i < 40; i++) {
+        body << "NodeGene " << 8 + i << " 1 Hidden" << i << " HiddenNode " << functions[i % 4] << " " << i / 8 << " " << i % 8 << " ";
+    }
+    body << 160 << " ";
+    for (int i = 0; i < 160; i++) {
+        body << "LinkGene " << 48 + i << " 1 " << i % 48 << " " << 8 + (i * 7) % 40 << " " << weight(generator) << " ";
+    }
+    
+    std::ostringstream mindStream;
+    mindStream << "MATRIX 18 2 VALUES ";
+    for (int i = 0; i < 36; i++) {
+        mindStream << weight(generator) / 3 << " ";
+    }
+    mindStream << " | MATRIX 18 2 VALUES ";
+    for (int i = 0; i < 36; i++) {
+        mindStream << "0 ";
+    }
+    std::string mind = mindStream.str();
+    
+    Message message(GENOME_SPREAD_MESSAGE);
+    message.add("ID", "12").add("FITNESS", "0.123456").add("GENOME", body.str()).add("MIND", mind);
+    
+    const int repetitions = 500;
+    size_t thresholds[] = { 0, Message::DEFAULT_COMPRESSION_THRESHOLD };
+    size_t bytes[2];
+    for (int t = 0; t < 2; t++) {
+        Message::setCompressionThreshold(GENOME_SPREAD_MESSAGE, thresholds[t]);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; i++) {
+            std::string data = message.encode();
+            MessageView view(data.data(), data.size());
+            bytes[t] = data.size();
+            ASSERT_EQ(t == 1, (data[5] & Message::FLAG_COMPRESSED) != 0);
+            ASSERT_EQ(body.str(), view.get("GENOME").to_string());
+            ASSERT_EQ(mind, view.get("MIND").to_string());
+        }
+        double time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repetitions;
+        std::cout << (t == 0 ? "uncompressed: " : "compressed: ") << bytes[t] << " bytes on the wire, " << time << "us to encode and decode" << std::endl;
+    }
+    Message::setCompressionThreshold(GENOME_SPREAD_MESSAGE, Message::DEFAULT_COMPRESSION_THRESHOLD);
+    ASSERT_LT(bytes[1], bytes[0] / 2);
+}
+
+TEST(AngleFrame, CommandRoundTrip) {
+    std::vector<std::vector<double> > angles(3, std::vector<double>(2));
+    angles[2][1] = -0.25;
+    std::vector<char> buffer;
+    size_t size = AngleFrame::encodeCommand(buffer, 1.5, angles);
+    
+    AngleFrame frame(buffer.data(), size);
+    ASSERT_TRUE(frame.isValid());
+    ASSERT_EQ(AngleFrame::COMMAND, frame.getType());
+    ASSERT_EQ(1.5, frame.getTimestamp());
+    ASSERT_EQ(3, frame.getModulesCount());
+    ASSERT_EQ(-0.25, frame.getAngle(2, 1));
+    ASSERT_FALSE(AngleFrame(buffer.data(), size - 1).isValid());
+}
+
+/**
+ * Control steps of a 45 modules organism: the root sends the angles of every module, every other
+ * module reads them, moves and sends back its own angles, which the root reads. The frames have to
+ * give the root the same angles as the json messages they replace; the time of a step is printed.
+ */
+TEST(AngleFrame, MatchesJsonExchange) {
+    const size_t modules = 45;
+    const size_t motors = 3;
+    const int steps = 100;
+    const double move = 0.125;
+    std::vector<std::vector<double> > initial(modules, std::vector<double>(motors));
+    for (size_t i = 0; i < modules; i++) {
+        for (size_t j = 0; j < motors; j++) {
+            initial[i][j] = i * 0.25 - j * 0.5;
+        }
+    }
+    std::vector<std::vector<double> > next = initial;
+    std::vector<double> current(motors);
+    
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; step++) {
+        using namespace boost::property_tree;
+        ptree command;
+        command.put("type","command");
+        command.put("timestamp",step);
+        for (size_t i = 0; i < modules; i++) {
+            ptree sub;
+            for (size_t j = 0; j < motors; j++) {
+                sub.put(std::to_string(j),next[i][j]);
+            }
+            command.add_child(std::to_string(i), sub);
+        }
+        std::ostringstream commandString;
+        json_parser::write_json(commandString,command,false);
+        
+        for (size_t i = 1; i < modules; i++) {
+            std::istringstream commandStream(commandString.str());
+            ptree received;
+            json_parser::read_json(commandStream, received);
+            ptree sub = received.get_child(std::to_string(i));
+            for (size_t j = 0; j < motors; j++) {
+                current[j] = sub.get<double>(std::to_string(j)) + move;
+            }
+            
+            ptree inform;
+            inform.put("type","inform");
+            inform.put("index",std::to_string(i));
+            inform.put("timestamp",step);
+            for (size_t j = 0; j < motors; j++) {
+                inform.put(std::to_string(j),current[j]);
+            }
+            std::ostringstream informString;
+            json_parser::write_json(informString,inform,false);
+            
+            std::istringstream informStream(informString.str());
+            ptree informReceived;
+            json_parser::read_json(informStream, informReceived);
+            size_t index = informReceived.get<size_t>("index");
+            for (size_t j = 0; j < motors; j++) {
+                next[index][j] = informReceived.get<double>(std::to_string(j));
+            }
+        }
+    }
+    double jsonTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / steps;
+    std::vector<std::vector<double> > json = next;
+    
+    next = initial;
+    std::vector<char> commandBuffer;
+    std::vector<char> informBuffer;
+    start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; step++) {
+        size_t commandSize = AngleFrame::encodeCommand(commandBuffer, step, next);
+        for (size_t i = 1; i < modules; i++) {
+            AngleFrame command(commandBuffer.data(), commandSize);
+            command.copyAngles(i, current);
+            for (size_t j = 0; j < motors; j++) {
+                current[j] += move;
+            }
+            
+            size_t informSize = AngleFrame::encodeInform(informBuffer, step, i, current);
+            AngleFrame inform(informBuffer.data(), informSize);
+            inform.copyAngles(0, next[inform.getModuleIndex()]);
+        }
+    }
+    double frameTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / steps;
+    
+    ASSERT_EQ(json, next);
+    ASSERT_EQ(initial[0], next[0]);
+    for (size_t i = 1; i < modules; i++) {
+        for (size_t j = 0; j < motors; j++) {
+            ASSERT_EQ(initial[i][j] + steps * move, next[i][j]);
+        }
+    }
+    std::cout << "angles exchange per step, json: " << jsonTime << "us, frames: " << frameTime << "us" << std::endl;
+}
+
+TEST(GenomeStore, SendOncePerChannel) {
+    ASSERT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", GenomeStore::digest(""));
+    ASSERT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", GenomeStore::digest("abc"));
+    
+    GenomeStore sender;
+    GenomeStore receiver;
+    std::string genome(1000, 'g');
+    
+    Message first(GENOME_SPREAD_MESSAGE);
+    sender.add(first, "GENOME", genome, 1);
+    Message second(GENOME_SPREAD_MESSAGE);
+    sender.add(second, "GENOME", genome, 1);
+    ASSERT_TRUE(first.has("GENOME"));
+    ASSERT_FALSE(second.has("GENOME"));
+    
+    std::string content;
+    std::string missing;
+    std::string secondData = second.encode();
+    ASSERT_FALSE(receiver.resolve(MessageView(secondData.data(), secondData.size()), "GENOME", &content, &missing));
+    ASSERT_EQ(GenomeStore::digest(genome), missing);
+    
+    std::string firstData = first.encode();
+    ASSERT_TRUE(receiver.resolve(MessageView(firstData.data(), firstData.size()), "GENOME", &content));
+    ASSERT_TRUE(receiver.resolve(MessageView(secondData.data(), secondData.size()), "GENOME", &content));
+    ASSERT_EQ(genome, content);
+    
+    std::string legacy = "[GENOME_SPREAD_MESSAGE]*GENOMEoldGENOME*";
+    ASSERT_TRUE(receiver.resolve(MessageView(legacy.c_str(), legacy.size() + 1), "GENOME", &content));
+    ASSERT_EQ("old", content);
+    ASSERT_TRUE(receiver.contains(GenomeStore::digest("old")));
+    
+    // a text sent with the digest of another genome is stored, and reported, under its own digest
+    std::string digest;
+    Message forged(GENOME_SPREAD_MESSAGE);
+    forged.add("GENOME_DIGEST", GenomeStore::digest(genome)).add("GENOME", "forged");
+    std::string forgedData = forged.encode();
+    ASSERT_TRUE(receiver.resolve(MessageView(forgedData.data(), forgedData.size()), "GENOME", &content, &digest));
+    ASSERT_EQ("forged", content);
+    ASSERT_EQ(GenomeStore::digest("forged"), digest);
+    ASSERT_EQ(genome, *receiver.find(GenomeStore::digest(genome)));
+    ASSERT_FALSE(receiver.put(GenomeStore::digest(genome), "forged"));
+    ASSERT_TRUE(receiver.put(GenomeStore::digest(genome), genome));
+}
+
+TEST(GenomeStore, HoldAndDrop) {
+    GenomeStore store(2);
+    std::string held = store.put("held");
+    ASSERT_TRUE(store.hold(held));
+    ASSERT_FALSE(store.hold(GenomeStore::digest("unknown")));
+    
+    Message first(GENOME_SPREAD_MESSAGE);
+    store.add(first, "GENOME", "a", 1);
+    std::string b = store.put("b");
+    std::string c = store.put("c");
+    
+    // the held genome stays, of the others only the 2 most recent
+    ASSERT_EQ(3u, store.size());
+    ASSERT_TRUE(store.contains(held));
+    ASSERT_FALSE(store.contains(GenomeStore::digest("a")));
+    ASSERT_TRUE(store.contains(b));
+    ASSERT_TRUE(store.contains(c));
+    
+    // a dropped genome is sent in full again
+    Message second(GENOME_SPREAD_MESSAGE);
+    store.add(second, "GENOME", "a", 1);
+    ASSERT_TRUE(second.has("GENOME"));
+    ASSERT_FALSE(store.contains(b));
+    
+    // resolving a genome makes it recent
+    Message digestOnly(GENOME_SPREAD_MESSAGE);
+    store.addDigest(digestOnly, "GENOME", "c");
+    std::string data = digestOnly.encode();
+    std::string content;
+    ASSERT_TRUE(store.resolve(MessageView(data.data(), data.size()), "GENOME", &content));
+    store.release(held);
+    ASSERT_FALSE(store.contains(GenomeStore::digest("a")));
+    ASSERT_TRUE(store.contains(c));
+    ASSERT_TRUE(store.contains(held));
+    ASSERT_EQ(2u, store.size());
+}
+
+TEST(GenomeStore, MatingAfterDrop) {
+    GenomeStore robot;
+    GenomeStore evolver(1);
+    std::string genome1(1000, '1'), mind1(100, 'a');
+    std::string genome2(1000, '2'), mind2(100, 'b');
+    
+    // as MatingStrategy::sendCoupleMessage
+    Message couple(COUPLE_MESSAGE);
+    robot.addFull(couple, "GENOME1", genome1);
+    robot.addFull(couple, "MIND1", mind1);
+    robot.addFull(couple, "GENOME2", genome2);
+    robot.addFull(couple, "MIND2", mind2);
+    std::string data = couple.encode();
+    
+    std::string content;
+    std::string digest;
+    for (int i = 0; i < 2; i++)
+    {
+        // as EvolverController::readCoupleMessage
+        MessageView view(data.data(), data.size());
+        ASSERT_TRUE(evolver.resolve(view, "GENOME1", &content, &digest));
+        ASSERT_EQ(genome1, content);
+        ASSERT_TRUE(evolver.resolve(view, "MIND1", &content, &digest));
+        ASSERT_TRUE(evolver.resolve(view, "GENOME2", &content, &digest));
+        ASSERT_TRUE(evolver.resolve(view, "MIND2", &content, &digest));
+        ASSERT_EQ(mind2, content);
+        ASSERT_EQ(GenomeStore::digest(mind2), digest);
+        
+        // the genomes of the first couple are dropped before the second one mates
+        ASSERT_FALSE(evolver.contains(GenomeStore::digest(genome1)));
+    }
+    
+    // sending only the digest once per channel would have lost the mating
+    Message first(COUPLE_MESSAGE);
+    robot.add(first, "GENOME1", genome1, 1);
+    Message second(COUPLE_MESSAGE);
+    robot.add(second, "GENOME1", genome1, 1);
+    std::string secondData = second.encode();
+    ASSERT_FALSE(evolver.resolve(MessageView(secondData.data(), secondData.size()), "GENOME1", &content));
+}
+
+/**
+ * @return A directory of the system's temporary directory, created for this run of the tests
+ * and removed at its end, so that the tests write nothing in the working directory.
+ */
+static const boost::filesystem::path & temporaryDirectory()
+{
+    static const boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("UnitTests-%%%%-%%%%-%%%%");
+    boost::filesystem::create_directories(directory);
+    return directory;
+}
+
+static std::string temporaryPath(const std::string & name)
+{
+    return (temporaryDirectory() / name).string();
+}
+
+TEST(ChannelTraffic, Store) {
+    std::string path = temporaryPath("channel_traffic_test.txt");
+    std::remove(path.c_str());
+    
+    ChannelTraffic traffic;
+    traffic.countSent(1000, 10);
+    traffic.countSent(1000, 30);
+    traffic.countReceived(1000, 20);
+    traffic.countQueueLength(1000, 4);
+    traffic.countQueueLength(1000, 2);
+    traffic.store(path, "evolver", 1.5);
+    traffic.store(path, "evolver", 2.5);
+    
+    std::ifstream file(path);
+    std::string header, line, end;
+    std::getline(file, header);
+    std::getline(file, line);
+    ASSERT_EQ('#', header[0]);
+    ASSERT_EQ("1.500000 evolver 1000 2 40 1 20 30 4 3.000000", line);
+    ASSERT_FALSE(std::getline(file, end));
+    std::remove(path.c_str());
+}
+
+TEST(LocalRadio, ChannelsAndRange) {
+    LocalRadioBus bus;
+    LocalEmitter * emitter = bus.createEmitter(1);
+    LocalReceiver * sameChannel = bus.createReceiver(1);
+    LocalReceiver * otherChannel = bus.createReceiver(2);
+    LocalReceiver * allChannels = bus.createReceiver(LocalRadioBus::CHANNEL_BROADCAST);
+    LocalReceiver * farAway = bus.createReceiver(1);
+    farAway->setPosition(10, 0, 0);
+    
+    emitter->setRange(5);
+    emitter->send("first", 6);
+    ASSERT_EQ(0, sameChannel->getQueueLength());
+    ASSERT_EQ(NULL, sameChannel->getData());
+    
+    bus.step();
+    ASSERT_EQ(1, sameChannel->getQueueLength());
+    ASSERT_EQ(0, otherChannel->getQueueLength());
+    ASSERT_EQ(1, allChannels->getQueueLength());
+    ASSERT_EQ(0, farAway->getQueueLength());
+    
+    emitter->setRange(-1);
+    emitter->send("second", 7);
+    bus.step();
+    ASSERT_EQ(1, farAway->getQueueLength());
+    ASSERT_EQ(2, sameChannel->getQueueLength());
+    ASSERT_STREQ("first", (const char *) sameChannel->getData());
+    ASSERT_EQ(6, sameChannel->getDataSize());
+    sameChannel->nextPacket();
+    ASSERT_STREQ("second", (const char *) sameChannel->getData());
+    sameChannel->nextPacket();
+    ASSERT_EQ(0, sameChannel->getQueueLength());
+    
+    emitter->setChannel(LocalRadioBus::CHANNEL_BROADCAST);
+    emitter->send("third", 6);
+    bus.step();
+    ASSERT_EQ(1, otherChannel->getQueueLength());
+    ASSERT_EQ(3, bus.getSentPackets());
+    ASSERT_EQ(9, bus.getDeliveredPackets());
+}
+
+/**
+ * Organisms finding their mates with the controllers' ProximityMating, over a range-limited channel,
+ * and sending their couples to a MessageDispatcher handling them as EvolverController::readCoupleMessage.
+ * One organism is out of range when the genomes are sent in full and has to request them.
+ */
+TEST(LocalRadio, ProximityMating) {
+    const int SIDE = 10;
+    const int ORGANISMS = SIDE * SIDE;
+    const int LATE = 44;
+    const double RANGE = 1.5;
+    const int ARRIVAL = 6;
+    const int STEPS = 20;
+    const int GENOME_EXCHANGE_CHANNEL = ParametersReader::get<int>("GENOME_EXCHANGE_CHANNEL");
+    const int EVOLVER_CHANNEL = ParametersReader::get<int>("EVOLVER_CHANNEL");
+    
+    LocalRadioBus bus;
+    std::vector<std::unique_ptr<WorldModel> > worldModels;
+    std::vector<std::unique_ptr<MessageHandler> > handlers;
+    std::vector<std::unique_ptr<MessageHandler> > evolverHandlers;
+    std::vector<std::unique_ptr<ProximityMating> > matings;
+    LocalReceiver * late = NULL;
+    for (int i = 0; i < ORGANISMS; i++)
+    {
+        WorldModel * worldModel = new WorldModel();
+        worldModel->organismId = i + 1;
+        worldModel->robotName = "Organism_" + std::to_string(i + 1);
+        worldModel->simulationDateAndTime = "LocalRadio.ProximityMating";  // not a directory, nothing is logged
+        worldModel->now = 0;
+        worldModel->adult = true;
+        worldModel->fertile = true;
+        worldModel->adultFitness = i;
+        for (int j = 0; j < 300; j++)
+        {
+            worldModel->bodyGenome += std::to_string((i * 7 + j * 13) % 97) + " ";
+        }
+        worldModel->mindGenome = "mind " + std::to_string(i);
+        worldModels.push_back(std::unique_ptr<WorldModel>(worldModel));
+        
+        double x = i % SIDE;
+        double y = i / SIDE;
+        LocalEmitter * emitter = bus.createEmitter(GENOME_EXCHANGE_CHANNEL);
+        emitter->setPosition(x, y, 0);
+        emitter->setRange(RANGE);
+        LocalReceiver * receiver = bus.createReceiver(GENOME_EXCHANGE_CHANNEL);
+        receiver->setPosition(x, y, 0);
+        if (i == LATE)
+        {
+            late = receiver;
+            receiver->setPosition(1000, 1000, 0);
+        }
+        handlers.push_back(std::unique_ptr<MessageHandler>(new MessageHandler(emitter, receiver)));
+        evolverHandlers.push_back(std::unique_ptr<MessageHandler>(new MessageHandler(bus.createEmitter(EVOLVER_CHANNEL), NULL)));
+        matings.push_back(std::unique_ptr<ProximityMating>(new ProximityMating(*worldModel, *handlers.back(), *evolverHandlers.back())));
+    }
+    LocalReceiver * evolverReceiver = bus.createReceiver(EVOLVER_CHANNEL);
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int step = 0; step < STEPS; step++)
+    {
+        if (step == ARRIVAL)
+        {
+            // after the genomes were sent in full
+            late->setPosition(LATE % SIDE, LATE / SIDE, 0);
+        }
+        for (int i = 0; i < ORGANISMS; i++)
+        {
+            worldModels[i]->now = step;
+            matings[i]->findMates();
+        }
+        bus.step();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    
+    // every organism in range is a candidate, the organism itself too as its receiver gets its own packets
+    for (int i = 0; i < ORGANISMS; i++)
+    {
+        std::vector<id_t> expected;
+        for (int j = 0; j < ORGANISMS; j++)
+        {
+            double dx = i % SIDE - j % SIDE;
+            double dy = i / SIDE - j / SIDE;
+            if (dx * dx + dy * dy <= RANGE * RANGE)
+            {
+                expected.push_back(j + 1);
+            }
+        }
+        std::vector<Organism> candidates = matings[i]->getCandidates();
+        std::vector<id_t> ids;
+        for (size_t k = 0; k < candidates.size(); k++)
+        {
+            ids.push_back(candidates[k].getId());
+            ASSERT_EQ(worldModels[candidates[k].getId() - 1]->bodyGenome, candidates[k].getGenome());
+            ASSERT_EQ(worldModels[candidates[k].getId() - 1]->mindGenome, candidates[k].getMind());
+        }
+        std::sort(ids.begin(), ids.end());
+        ASSERT_EQ(expected, ids) << "organism " << i + 1;
+    }
+    
+    GenomeStore evolverStore(1);
+    unsigned long couples = 0;
+    MessageDispatcher dispatcher;
+    dispatcher.registerHandler(COUPLE_MESSAGE, [&](const MessageView & message) {
+        id_t id1 = message.getLong("ID1");
+        id_t id2 = message.getLong("ID2");
+        std::string genome1, mind1, genome2, mind2;
+        if (!evolverStore.resolve(message, "GENOME1", &genome1) || !evolverStore.resolve(message, "MIND1", &mind1) ||
+            !evolverStore.resolve(message, "GENOME2", &genome2) || !evolverStore.resolve(message, "MIND2", &mind2))
+        {
+            return false;
+        }
+        EXPECT_EQ(worldModels[id1 - 1]->bodyGenome, genome1);
+        EXPECT_EQ(worldModels[id1 - 1]->mindGenome, mind1);
+        EXPECT_EQ(worldModels[id2 - 1]->bodyGenome, genome2);
+        EXPECT_EQ(worldModels[id2 - 1]->mindGenome, mind2);
+        couples++;
+        return true;
+    });
+    
+    for (int i = 0; i < ORGANISMS; i++)
+    {
+        matings[i]->mate();
+    }
+    bus.step();
+    while (evolverReceiver->getQueueLength() > 0)
+    {
+        ASSERT_TRUE(dispatcher.dispatch(MessageView(evolverReceiver->getData(), evolverReceiver->getDataSize())));
+        evolverReceiver->nextPacket();
+    }
+    ASSERT_EQ(ORGANISMS, couples);
+    std::cout << bus.getSentPackets() << " packets sent, " << bus.getDeliveredPackets() << " delivered in " << seconds << "s, "
+              << bus.getDeliveredPackets() / seconds << " packets/s" << std::endl;
+}
+
+TEST(OrganismRegistry, AddFindRemove) {
+    OrganismRegistry registry;
+    for (id_t id = 1; id <= 4; id++)
+    {
+        registry.add(Organism("genome", "mind", id, 0, 1, 0, std::vector<id_t>(), Organism::INFANT, false));
+    }
+    ASSERT_EQ(4, registry.size());
+    ASSERT_EQ(2, registry.find(3));
+    ASSERT_EQ(-1, registry.find(5));
+    
+    registry.remove(1);
+    ASSERT_FALSE(registry.contains(2));
+    ASSERT_EQ(1, registry.find(3));
+    ASSERT_EQ(2, registry.find(4));
+    ASSERT_EQ(3, registry[registry.find(3)].getId());
+    
+    registry.add(Organism("genome", "mind", 2, 0, 1, 0, std::vector<id_t>(), Organism::INFANT, false));
+    ASSERT_EQ(3, registry.find(2));
+    registry.setState(registry.find(2), Organism::ADULT);
+    ASSERT_EQ(Organism::ADULT, registry[3].getState());
+    
+    registry[registry.find(3)].setOffspring(2);
+    registry.archive(registry.find(3));
+    ASSERT_EQ(-1, registry.find(3));
+    ASSERT_EQ(3, registry.size());
+    ASSERT_EQ(1, registry.getArchivedCount());
+    ASSERT_EQ(2, registry.findArchived(3)->offspring);
+    ASSERT_EQ(NULL, registry.findArchived(4));
+    
+    registry.archiveAll();
+    ASSERT_TRUE(registry.empty());
+    ASSERT_EQ(4, registry.getArchivedCount());
+}
+
+TEST(OrganismRegistry, ReplayedLifetimes) {
+    // replays the messages the evolver handles for every organism: birth (with the lookup of both
+    // parents), adult, fertile, fitness updates and death, and checks the registry against a map
+    const int BORN = 20000;
+    const int WINDOW = 5000;
+    const int ALIVE = 100;
+    
+    OrganismRegistry registry;
+    std::map<id_t, unsigned int> offspring;
+    std::map<id_t, bool> adult;
+    std::mt19937 generator(42);
+    std::vector<id_t> parents(2);
+    auto windowStart = std::chrono::high_resolution_clock::now();
+    for (id_t id = 1; id <= BORN; id++)
+    {
+        id_t firstAlive = id > ALIVE ? id - ALIVE : 1;
+        parents[0] = id > 1 ? firstAlive + generator() % (id - firstAlive) : 0;
+        parents[1] = id > 1 ? firstAlive + generator() % (id - firstAlive) : 0;
+        for (int i = 0; i < 2; i++)
+        {
+            int index = registry.find(parents[i]);
+            ASSERT_EQ(offspring.count(parents[i]) == 1, index >= 0);
+            if (index >= 0)
+            {
+                registry[index].setOffspring(registry[index].getOffspring() + 1);
+                offspring[parents[i]]++;
+            }
+        }
+        registry.add(Organism("genome", "mind", id, 0, 10, 0, parents, Organism::INFANT, false));
+        offspring[id] = 0;
+        adult[id] = false;
+        
+        id_t other = firstAlive + generator() % (id - firstAlive + 1);
+        registry.setState(registry.find(other), Organism::ADULT);
+        registry.setFertile(registry.find(other), true);
+        for (int i = 0; i < 5; i++)
+        {
+            registry.setFitness(registry.find(other), i);
+        }
+        adult[other] = true;
+        if (id > ALIVE)
+        {
+            registry.archive(registry.find(id - ALIVE));
+            offspring.erase(id - ALIVE);
+            adult.erase(id - ALIVE);
+        }
+        
+        if (id % WINDOW == 0)
+        {
+            double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - windowStart).count();
+            std::cout << id << " organisms born: " << seconds / (WINDOW * 10) * 1e9 << "ns per message" << std::endl;
+            windowStart = std::chrono::high_resolution_clock::now();
+        }
+    }
+    
+    ASSERT_EQ(ALIVE, registry.size());
+    ASSERT_EQ(BORN - ALIVE, registry.getArchivedCount());
+    unsigned int adults = 0;
+    for (std::map<id_t, unsigned int>::iterator it = offspring.begin(); it != offspring.end(); ++it)
+    {
+        int index = registry.find(it->first);
+        ASSERT_GE(index, 0);
+        ASSERT_EQ(it->first, registry[index].getId());
+        ASSERT_EQ(it->second, registry[index].getOffspring());
+        ASSERT_EQ(adult[it->first] ? Organism::ADULT : Organism::INFANT, registry[index].getState());
+        adults += adult[it->first];
+    }
+    ASSERT_EQ(-1, registry.find(BORN - ALIVE));
+    ASSERT_EQ(adults, registry.getStatistics().adults);
+    ASSERT_EQ(ALIVE - adults, registry.getStatistics().infants);
+    ASSERT_EQ(ALIVE * 10, registry.getStatistics().modules);
+}
+
+TEST(OrganismRegistry, Statistics) {
+    OrganismRegistry registry;
+    for (id_t id = 1; id <= 4; id++)
+    {
+        registry.add(Organism("genome", "mind", id, 0, id, 0, std::vector<id_t>(), Organism::INFANT, false));
+    }
+    ASSERT_EQ(4, registry.getStatistics().infants);
+    ASSERT_EQ(10, registry.getStatistics().modules);
+    
+    for (id_t id = 1; id <= 3; id++)
+    {
+        registry.setState(registry.find(id), Organism::ADULT);
+        registry.setFitness(registry.find(id), id);
+    }
+    registry.setFertile(registry.find(2), true);
+    const OrganismRegistry::Statistics & statistics = registry.getStatistics();
+    ASSERT_EQ(1, statistics.infants);
+    ASSERT_EQ(3, statistics.adults);
+    ASSERT_EQ(1, statistics.fertile);
+    ASSERT_DOUBLE_EQ(2, statistics.getFitnessMean());
+    ASSERT_DOUBLE_EQ(2.0 / 3, statistics.getFitnessVariance());
+    ASSERT_EQ(3, registry.getMaxFitness());
+    
+    registry.archive(registry.find(3));
+    registry.archive(registry.find(2));
+    ASSERT_EQ(1, statistics.adults);
+    ASSERT_EQ(0, statistics.fertile);
+    ASSERT_EQ(5, statistics.modules);
+    ASSERT_DOUBLE_EQ(1, statistics.getFitnessMean());
+    ASSERT_EQ(1, registry.getMaxFitness());
+    
+    registry.setFitness(registry.find(1), std::nan(""));
+    ASSERT_DOUBLE_EQ(0, statistics.getFitnessMean());
+    registry.setFitness(registry.find(1), 4);
+    ASSERT_DOUBLE_EQ(4, statistics.getFitnessMean());
+    ASSERT_EQ(4, registry.getMaxFitness());
+    
+    registry.archiveAll();
+    ASSERT_EQ(0, statistics.adults + statistics.infants);
+    ASSERT_EQ(0, statistics.modules);
+    ASSERT_EQ(0, registry.getMaxFitness());
+}
+
+TEST(OrganismsHistory, RebuildsRegistry) {
+    OrganismRegistry registry;
+    std::stringstream delta;
+    double time = 0;
+    registry.setChangeListener([&delta, &time](OrganismRegistry::Change change, const Organism & organism) {
+        delta << OrganismsHistory::format(time, change, organism.getId(), organism.getState());
+    });
+    
+    // births, deaths, rebirths of the same id and state changes, with a snapshot of the list every second
+    std::mt19937 generator(7);
+    std::vector<std::string> snapshots;
+    id_t nextId = 1;
+    for (int second = 0; second < 200; second++)
+    {
+        for (int event = 0; event < 5; event++)
+        {
+            time = second + event * 0.1;
+            unsigned int kind = generator() % 4;
+            if (kind == 0 || registry.size() < 3)
+            {
+                registry.add(Organism("genome", "mind", nextId++, 0, 1, 0, std::vector<id_t>(), Organism::INFANT, false));
+            }
+            else if (kind == 1)
+            {
+                registry.setState(generator() % registry.size(), Organism::ADULT);
+            }
+            else if (kind == 2)
+            {
+                registry.archive(generator() % registry.size());
+            }
+            else
+            {
+                size_t index = generator() % registry.size();
+                id_t id = registry[index].getId();
+                registry.remove(index);
+                registry.add(Organism("genome", "mind", id, 0, 1, 0, std::vector<id_t>(), Organism::INFANT, false));
+            }
+        }
+        std::string snapshot;
+        for (size_t i = 0; i < registry.size(); i++)
+        {
+            snapshot += std::to_string(i) + " " + std::to_string(registry[i].getId()) + " " + std::to_string(registry[i].getState()) + "\n";
+        }
+        snapshots.push_back(snapshot);
+    }
+    time = 200;
+    registry.archiveAll();
+    
+    std::stringstream file(OrganismsHistory::HEADER + delta.str());
+    std::vector<OrganismsHistory::Change> changes = OrganismsHistory::read(file);
+    OrganismsHistory history;
+    for (int second = 0; second < 200; second++)
+    {
+        history.applyUntil(changes, second + 0.5);
+        ASSERT_EQ(snapshots[second], history.toString());
+    }
+    history.applyUntil(changes, 1000);
+    ASSERT_TRUE(history.getOrganisms().empty());
+}
+
+TEST(Organism, CopySharesGenomes) {
+    std::vector<id_t> parents;
+    parents.push_back(1);
+    parents.push_back(2);
+    Organism organism(std::string(5000, 'g'), std::string(5000, 'm'), 3, 0.5, 10, 0, parents, Organism::ADULT, true);
+    
+    std::vector<Organism> copies(1000, organism);
+    ASSERT_EQ(organism.getGenome().data(), copies[999].getGenome().data());
+    ASSERT_EQ(organism.getMind().data(), copies[999].getMind().data());
+    ASSERT_EQ(2, copies[999].getParents()[1]);
+    
+    copies[0].setGenome("other");
+    copies[0].setFitness(1);
+    ASSERT_EQ(5000, organism.getGenome().size());
+    ASSERT_EQ(0.5, organism.getFitness());
+    ASSERT_EQ("other", copies[0].getGenome());
+}
+
+TEST(Organism, Digests) {
+    Organism organism("genome", "mind", 1, 0, 1, 0, std::vector<id_t>(), Organism::ADULT, true);
+    ASSERT_EQ(GenomeStore::digest("genome"), organism.getGenomeDigest());
+    ASSERT_EQ(GenomeStore::digest("mind"), organism.getMindDigest());
+    
+    // digests known from GenomeStore::resolve are kept as they are, and shared by the copies
+    Organism received("genome", "mind", 2, 0, 1, 0, std::vector<id_t>(), Organism::ADULT, true);
+    received.setDigests("genome digest", "mind digest");
+    Organism copy(received);
+    ASSERT_EQ("genome digest", copy.getGenomeDigest());
+    ASSERT_EQ(received.getMindDigest().data(), copy.getMindDigest().data());
+    
+    copy.setMind("other");
+    ASSERT_EQ(GenomeStore::digest("other"), copy.getMindDigest());
+    ASSERT_EQ("genome digest", copy.getGenomeDigest());
+    ASSERT_EQ("mind digest", received.getMindDigest());
+}
+
+TEST(LruCache, EvictsLeastRecentlyUsed) {
+    LruCache<std::string, int> cache(2);
+    cache.put("a", 1);
+    cache.put("b", 2);
+    ASSERT_EQ(1, *cache.find("a"));
+    cache.put("c", 3);
+    ASSERT_EQ(NULL, cache.find("b"));
+    ASSERT_EQ(1, *cache.find("a"));
+    ASSERT_EQ(3, *cache.find("c"));
+    cache.put("a", 4);
+    ASSERT_EQ(4, *cache.find("a"));
+    ASSERT_EQ(2, cache.size());
+    ASSERT_EQ(4, cache.getHits());
+    ASSERT_EQ(1, cache.getMisses());
+    
+    LruCache<std::string, int> disabled(0);
+    disabled.put("a", 1);
+    ASSERT_EQ(NULL, disabled.find("a"));
+}
+
+TEST(LruCache, ParsedMindReused) {
+    // the evolver parses the mind of a parent once, and hands the same genome to its next matings
+    MatrixGenomeManager manager;
+    MatrixGenome parent(18, 40);
+    MatrixGenome other(18, 40);
+    std::string text = parent.toString();
+    std::string otherText = other.toString();
+    std::string digest = GenomeStore::digest(text);
+    const int MATINGS = 200;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < MATINGS; i++)
+    {
+        std::stringstream stream(text);
+        ASSERT_TRUE(manager.getGenomeFromStream(stream).get() != NULL);
+    }
+    double parsing = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    
+    LruCache<std::string, boost::shared_ptr<MindGenome> > cache(64);
+    MindGenome * first = NULL;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < MATINGS; i++)
+    {
+        boost::shared_ptr<MindGenome> * parsed = cache.find(digest);
+        boost::shared_ptr<MindGenome> genome;
+        if (parsed == NULL)
+        {
+            std::stringstream stream(text);
+            genome = manager.getGenomeFromStream(stream);
+            cache.put(digest, genome);
+            first = genome.get();
+        }
+        else
+        {
+            genome = *parsed;
+        }
+        ASSERT_EQ(first, genome.get());
+    }
+    double cached = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    
+    ASSERT_EQ(MATINGS - 1, cache.getHits());
+    ASSERT_EQ(1, cache.getMisses());
+    ASSERT_EQ(text, (*cache.find(digest))->toString());
+    ASSERT_EQ(NULL, cache.find(GenomeStore::digest(otherText)));
+    std::cout << text.size() << " bytes mind: parsing " << parsing / MATINGS * 1e6 << "us, cached " << cached / MATINGS * 1e6 << "us" << std::endl;
+}
+
+TEST(WorkerPool, RunsEveryTask) {
+    for (unsigned int threads = 0; threads <= 4; threads++)
+    {
+        WorkerPool pool(threads);
+        for (int batch = 0; batch < 20; batch++)
+        {
+            std::vector<int> results(50, -1);
+            pool.run(results.size(), [&results](size_t i) {
+                results[i] = (int) i * 2;
+            });
+            for (size_t i = 0; i < results.size(); i++)
+            {
+                ASSERT_EQ(i * 2, results[i]);
+            }
+        }
+        pool.run(0, [](size_t i) {});
+    }
+}
+
+TEST(WorkerPool, RethrowsException) {
+    WorkerPool pool(2);
+    std::vector<char> ran(10, 0);
+    ASSERT_THROW(pool.run(ran.size(), [&ran](size_t i) {
+        ran[i] = 1;
+        if (i == 3)
+        {
+            throw std::runtime_error("candidate failed");
+        }
+    }), std::runtime_error);
+    ASSERT_EQ(10, std::count(ran.begin(), ran.end(), 1));
+    
+    pool.run(ran.size(), [&ran](size_t i) {
+        ran[i] = 2;
+    });
+    ASSERT_EQ(10, std::count(ran.begin(), ran.end(), 2));
+}
+
+TEST(WorkerPool, ScreeningMatchesSerial) {
+    // stands for the build plans of a batch of offspring candidates
+    auto screen = [](size_t i) {
+        double value = (double) i;
+        for (int j = 0; j < 20000; j++)
+        {
+            value = std::sqrt(value + j);
+        }
+        return value;
+    };
+    const size_t CANDIDATES = 16;
+    std::vector<double> expected(CANDIDATES);
+    for (size_t i = 0; i < CANDIDATES; i++)
+    {
+        expected[i] = screen(i);
+    }
+    for (unsigned int threads = 0; threads <= 3; threads++)
+    {
+        WorkerPool pool(threads);
+        std::vector<double> results(CANDIDATES);
+        auto start = std::chrono::high_resolution_clock::now();
+        pool.run(CANDIDATES, [&results, &screen](size_t i) {
+            results[i] = screen(i);
+        });
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        ASSERT_EQ(expected, results);
+        std::cout << threads << " workers besides the caller: " << seconds * 1000 << "ms per batch" << std::endl;
+    }
+}
+
+TEST(EventJournal, MatchesDirectWrites) {
+    std::string direct = temporaryPath("event_journal_direct.txt");
+    std::string journaled = temporaryPath("event_journal_test.txt");
+    std::string other = temporaryPath("event_journal_other.txt");
+    std::remove(direct.c_str());
+    std::remove(journaled.c_str());
+    std::remove(other.c_str());
+    
+    {
+        // a tiny buffer, so that writes have to wait for the writer
+        EventJournal journal(64, 10);
+        for (int i = 0; i < 1000; i++)
+        {
+            std::string line = std::to_string(i) + " DEATH " + std::to_string(i * 7) + "\n";
+            std::ofstream file(direct, std::ios::app);
+            file << (i == 0 ? "#time id\n" : "") << line;
+            journal.write(journaled, line, "#time id\n");
+            journal.write(other, "x");
+        }
+        journal.flush();
+        ASSERT_EQ(0, journal.getBufferedSize());
+        journal.write(other, "y");
+    }
+    
+    std::ifstream directFile(direct), journaledFile(journaled), otherFile(other);
+    std::stringstream expected, actual, rest;
+    expected << directFile.rdbuf();
+    actual << journaledFile.rdbuf();
+    rest << otherFile.rdbuf();
+    ASSERT_EQ(expected.str(), actual.str());
+    ASSERT_EQ(std::string(1000, 'x') + "y", rest.str());
+    
+    // the header is only written to new files
+    {
+        EventJournal journal(1024, 10);
+        journal.write(journaled, "1000 DEATH 0\n", "#time id\n");
+    }
+    std::ifstream appendedFile(journaled);
+    std::stringstream appended;
+    appended << appendedFile.rdbuf();
+    ASSERT_EQ(expected.str() + "1000 DEATH 0\n", appended.str());
+    
+    std::remove(direct.c_str());
+    std::remove(journaled.c_str());
+    std::remove(other.c_str());
+}
+
+TEST(EventJournal, MatchesAppendedEvents) {
+    // the evolver used to open, append to and close its results files for every event
+    std::string direct = temporaryPath("event_journal_appended.txt");
+    std::string journaled = temporaryPath("event_journal_journaled.txt");
+    const int EVENTS = 5000;
+    std::remove(direct.c_str());
+    std::remove(journaled.c_str());
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < EVENTS; i++)
+    {
+        std::ofstream file;
+        file.open(direct, std::ios::app);
+        file << i << " PROCREATE 1 and 2 successfully had child " << i << std::endl;
+        file.close();
+    }
+    double appended = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    
+    start = std::chrono::high_resolution_clock::now();
+    double written;
+    {
+        EventJournal journal(1 << 20, 1);
+        for (int i = 0; i < EVENTS; i++)
+        {
+            journal.write(journaled, std::to_string(i) + " PROCREATE 1 and 2 successfully had child " + std::to_string(i) + "\n");
+        }
+        written = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    double journaledTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    
+    std::ifstream directFile(direct), journaledFile(journaled);
+    std::stringstream expected, actual;
+    expected << directFile.rdbuf();
+    actual << journaledFile.rdbuf();
+    ASSERT_EQ(expected.str(), actual.str());
+    std::remove(direct.c_str());
+    std::remove(journaled.c_str());
+    
+    std::cout << EVENTS << " events: open/append/close " << appended / EVENTS * 1e6 << "us each, journal "
+              << written / EVENTS * 1e6 << "us each (" << journaledTime * 1000 << "ms including the final write)" << std::endl;
+}
+
+/**
+ * An ActivationValueMatrix searched the way it was before the values were evaluated once per matrix
+ * and the adjacent cells kept in a heap: every search reads the values of the cells it considers,
+ * the adjacent cells are scanned in Coordinate order, and reads counts the values read, which
+ * is the number of times the CPPN was activated when it was queried on every read.
+ */
+class ScanningMatrix : public ActivationValueMatrix
+{
+public:
+    
+    ScanningMatrix(const std::vector<double> & values, int width, int height) : ActivationValueMatrix(values, width, height), reads(0), adjacentCells(width * height, false)
+    {
+        //nix
+    }
+    
+    Coordinate getMax() const
+    {
+        Coordinate result(0, 0, THRESHOLD);
+        for (int x = 0; x < getWidth(); x++) {
+            for (int y = 0; y < getHeight(); y++) {
+                if (read(x, y) > result.value && !getUsed(x, y)) {
+                    result = Coordinate(x, y, read(x, y));
+                    result.found = true;
+                }
+            }
+        }
+        return result;
+    }
+    
+    Coordinate getMaxNeighbour(const Coordinate& coordinate) const
+    {
+        Coordinate result(0, 0, THRESHOLD);
+        int xMod[NEIGHBOURS] = {-1, 1, 0, 0};
+        int yMod[NEIGHBOURS] = {0, 0, -1, 1};
+        for (int i = 0; i < NEIGHBOURS; i++) {
+            int x = coordinate.x + xMod[i];
+            int y = coordinate.y + yMod[i];
+            if (inBounds(x, y) && !getUsed(x, y) && read(x, y) > result.value) {
+                result = Coordinate(x, y, read(x, y));
+                result.found = true;
+            }
+        }
+        return result;
+    }
+    
+    Coordinate getMaxAdjacent() const
+    {
+        Coordinate result(0, 0, THRESHOLD);
+        for (int x = 0; x < getWidth(); x++) {
+            for (int y = 0; y < getHeight(); y++) {
+                if (adjacentCells[x * getHeight() + y] && read(x, y) > result.value && !getUsed(x, y)) {
+                    result = Coordinate(x, y, read(x, y));
+                    result.found = true;
+                }
+            }
+        }
+        return result;
+    }
+    
+    void setUsed(const Coordinate& coordinate, bool newUsed)
+    {
+        ActivationValueMatrix::setUsed(coordinate, newUsed);
+        adjacentCells[coordinate.x * getHeight() + coordinate.y] = false;
+    }
+    
+    void addModuleCoordinate(const Coordinate& coordinate)
+    {
+        ActivationValueMatrix::addModuleCoordinate(coordinate);
+        int xMod[NEIGHBOURS] = {-1, 1, 0, 0};
+        int yMod[NEIGHBOURS] = {0, 0, -1, 1};
+        for (int i = 0; i < NEIGHBOURS; i++) {
+            int x = coordinate.x + xMod[i];
+            int y = coordinate.y + yMod[i];
+            if (inBounds(x, y) && !getUsed(x, y)) {
+                adjacentCells[x * getHeight() + y] = true;
+            }
+        }
+    }
+    
+    mutable size_t reads;
+    
+private:
+    
+    double read(int x, int y) const
+    {
+        reads++;
+        return get(x, y);
+    }
+    
+    std::vector<char> adjacentCells;
+};
+
+/**
+ * @return The values of a grid of CPPN outputs, between -1 and 1, drawn from a few levels
+ * when levels is not 0, so that many cells have the same value.
+ */
+static std::vector<double> randomActivations(std::mt19937 & generator, int width, int height, int levels = 0)
+{
+    std::uniform_real_distribution<double> value(-1, 1);
+    std::uniform_int_distribution<int> level(0, levels);
+    std::vector<double> values(width * height);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        values[i] = levels == 0 ? value(generator) : -1 + 2.0 * level(generator) / levels;
+    }
+    return values;
+}
+
+TEST(ActivationValueMatrix, GridActivations) {
+    // grids evolve by steps of one from the minimum size; larger grids than this are rare,
+    // since bodies are limited to NUMBER_OF_MODULES modules
+    const int LARGEST_GRID = 20;
+    const int GRIDS = 20;
+    std::mt19937 generator(1);
+    for (int size = ParametersReader::get<int>("CPPN_GRID_MINIMUM_SIZE"); size <= LARGEST_GRID; size++)
+    {
+        for (int i = 0; i < GRIDS; i++)
+        {
+            // evaluating the grid once activates the CPPN size * size times,
+            // querying it on every read activates it at least once for every cell
+            ScanningMatrix matrix(randomActivations(generator, size, size), size, size);
+            Builder::translate(matrix, std::numeric_limits<size_t>::max());
+            ASSERT_LE((size_t) size * size, matrix.reads);
+        }
+    }
+}
+
+/**
+ * Translating with the heap of adjacent cells places the same modules as scanning the adjacent cells,
+ * also when many cells have the same value and the order among equal values decides.
+ */
+TEST(ActivationValueMatrix, HeapMatchesScan) {
+    const int GRIDS = 1000;
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<int> size(ParametersReader::get<int>("CPPN_GRID_MINIMUM_SIZE"), 20);
+    for (int i = 0; i < GRIDS; i++)
+    {
+        int width = size(generator);
+        int height = size(generator);
+        std::vector<double> values = randomActivations(generator, width, height, i % 4);
+        
+        ActivationValueMatrix heap(values, width, height);
+        std::auto_ptr<BuildPlan> heapPlan = Builder::translate(heap, std::numeric_limits<size_t>::max());
+        ScanningMatrix scan(values, width, height);
+        std::auto_ptr<BuildPlan> scanPlan = Builder::translate(scan, std::numeric_limits<size_t>::max());
+        
+        ASSERT_EQ(scanPlan->size(), heapPlan->size());
+        for (size_t j = 0; j < scanPlan->size(); j++)
+        {
+            RelativePosition expected = static_cast<RoombotBuildPlan *>(scanPlan.get())->getRelativePosition(j);
+            RelativePosition actual = static_cast<RoombotBuildPlan *>(heapPlan.get())->getRelativePosition(j);
+            ASSERT_EQ(expected.x, actual.x);
+            ASSERT_EQ(expected.z, actual.z);
+            ASSERT_EQ(expected.isHorizontal, actual.isHorizontal);
+        }
+    }
+}
+
+/**
+ * Builder::hasModules(genome, 2) translates the matrix of the genome up to 2 modules: over random grids,
+ * with and without equal values, that tells whether the whole translation has 2 modules, places
+ * the same first modules, and reads no more values.
+ */
+TEST(Builder, HasModulesMatchesTranslation) {
+    const int GRIDS = 500;
+    std::mt19937 generator(2);
+    std::uniform_int_distribution<int> size(ParametersReader::get<int>("CPPN_GRID_MINIMUM_SIZE"), 12);
+    int viable = 0;
+    for (int i = 0; i < GRIDS; i++)
+    {
+        int width = size(generator);
+        std::vector<double> values = randomActivations(generator, width, width, i % 2 == 0 ? 0 : 3);
+        
+        ScanningMatrix partial(values, width, width);
+        std::auto_ptr<BuildPlan> partialPlan = Builder::translate(partial, 2);
+        ScanningMatrix whole(values, width, width);
+        std::auto_ptr<BuildPlan> wholePlan = Builder::translate(whole, std::numeric_limits<size_t>::max());
+        
+        ASSERT_EQ(wholePlan->size() >= 2, partialPlan->size() >= 2);
+        ASSERT_LE(partialPlan->size(), 2u);
+        ASSERT_LE(partial.reads, whole.reads);
+        for (size_t j = 0; j < partialPlan->size(); j++)
+        {
+            RelativePosition expected = static_cast<RoombotBuildPlan *>(wholePlan.get())->getRelativePosition(j);
+            RelativePosition actual = static_cast<RoombotBuildPlan *>(partialPlan.get())->getRelativePosition(j);
+            ASSERT_EQ(expected.x, actual.x);
+            ASSERT_EQ(expected.z, actual.z);
+            ASSERT_EQ(expected.isHorizontal, actual.isHorizontal);
+        }
+        if (wholePlan->size() > 2)
+        {
+            ASSERT_LT(partial.reads, whole.reads);
+        }
+        viable += partialPlan->size() >= 2;
+        
+        // and so does the ActivationValueMatrix that hasModules translates
+        ActivationValueMatrix matrix(values, width, width);
+        ASSERT_EQ(partialPlan->size(), Builder::translate(matrix, 2)->size());
+    }
+    // both answers occur
+    ASSERT_LT(0, viable);
+    ASSERT_GT(GRIDS, viable);
+}
+
+/**
+ * A network updated the way FastNetwork<double> is, written out from its definition and kept simple:
+ * every update sets each node that is not an input, all at the same time, to its activation function
+ * of the sum of its links, in the order of the genes, over the values of the previous update.
+ */
+class ReferenceNetwork
+{
+public:
+    
+    ReferenceNetwork(const std::vector<CompiledNetwork::Node> & nodes, const std::vector<CompiledNetwork::Connection> & connections, int extraActivationUpdates, bool signedActivation) :
+        nodes(nodes), connections(connections), values(nodes.size(), 0), extraActivationUpdates(extraActivationUpdates), signedActivation(signedActivation), activated(false)
+    {
+        //nix
+    }
+    
+    void setValue(int id, double value)
+    {
+        values[index(id)] = value;
+    }
+    
+    double getValue(int id) const
+    {
+        return values[index(id)];
+    }
+    
+    void setActivated(bool value)
+    {
+        activated = value;
+    }
+    
+    void update()
+    {
+        int iterations = activated ? 1 : 2 + extraActivationUpdates;
+        activated = true;
+        for (int i = 0; i < iterations; i++)
+        {
+            std::vector<double> sums(nodes.size(), 0);
+            for (size_t j = 0; j < connections.size(); j++)
+            {
+                sums[index(connections[j].to)] += values[index(connections[j].from)] * connections[j].weight;
+            }
+            for (size_t j = 0; j < nodes.size(); j++)
+            {
+                if (!nodes[j].input)
+                {
+                    values[j] = activate(nodes[j].function, sums[j]);
+                }
+            }
+        }
+    }
+    
+private:
+    
+    size_t index(int id) const
+    {
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            if (nodes[i].id == id) return i;
+        }
+        return nodes.size();
+    }
+    
+    double activate(ActivationFunction function, double x) const
+    {
+        switch (function)
+        {
+            case ACTIVATION_FUNCTION_SIGMOID: return signedActivation ? (1 / (1 + std::exp(-x)) - 0.5) * 2 : 1 / (1 + std::exp(-x));
+            case ACTIVATION_FUNCTION_SIN: return std::sin(x);
+            case ACTIVATION_FUNCTION_COS: return std::cos(x);
+            case ACTIVATION_FUNCTION_GAUSSIAN: return signedActivation ? (std::exp(-x * x) - 0.5) * 2 : std::exp(-x * x);
+            case ACTIVATION_FUNCTION_SQUARE: return x * x;
+            case ACTIVATION_FUNCTION_ABS_ROOT: return std::sqrt(std::fabs(x));
+            default: return x;
+        }
+    }
+    
+    std::vector<CompiledNetwork::Node> nodes;
+    std::vector<CompiledNetwork::Connection> connections;
+    std::vector<double> values;
+    int extraActivationUpdates;
+    bool signedActivation;
+    bool activated;
+};
+
+/**
+ * Evaluates random acyclic networks shaped like body CPPNs, with their genes in random order, on grids
+ * of cells, one cell after the other with CompiledNetwork and all at once with BatchedNetwork,
+ * and compares them with ReferenceNetwork. Runs without the NEAT library.
+ */
+TEST(CppnEvaluators, MatchReferenceNetwork) {
+    const int NETWORKS = 300;
+    const int BIAS = 0, X = 1, Y = 2, OUTPUT_ID = 1000;
+    std::mt19937 generator(4);
+    std::uniform_real_distribution<double> weight(-3, 3);
+    for (int i = 0; i < NETWORKS; i++)
+    {
+        std::vector<CompiledNetwork::Node> nodes;
+        CompiledNetwork::Node bias = {BIAS, INPUT_BIAS, true, ACTIVATION_FUNCTION_LINEAR};
+        CompiledNetwork::Node x = {X, INPUT_X, true, ACTIVATION_FUNCTION_LINEAR};
+        CompiledNetwork::Node y = {Y, INPUT_Y, true, ACTIVATION_FUNCTION_LINEAR};
+        CompiledNetwork::Node output = {OUTPUT_ID, OUTPUT, false, ACTIVATION_FUNCTION_SIGMOID};
+        nodes.push_back(bias);
+        nodes.push_back(x);
+        nodes.push_back(y);
+        nodes.push_back(output);
+        int hidden = generator() % 10;
+        for (int j = 0; j < hidden; j++)
+        {
+            CompiledNetwork::Node node = {10 + j, "Hidden" + std::to_string(j), false, (ActivationFunction) (generator() % ACTIVATION_FUNCTION_ONES_COMPLIMENT)};
+            nodes.push_back(node);
+        }
+        std::shuffle(nodes.begin() + 3, nodes.end(), generator);
+        
+        // links only go from lower to higher ids, so the network has no cycle
+        std::vector<CompiledNetwork::Connection> connections;
+        for (size_t j = 0; j < nodes.size(); j++)
+        {
+            for (size_t k = 0; k < nodes.size(); k++)
+            {
+                if (nodes[j].id < nodes[k].id && !nodes[k].input && generator() % 3 == 0)
+                {
+                    CompiledNetwork::Connection connection = {nodes[j].id, nodes[k].id, weight(generator)};
+                    connections.push_back(connection);
+                }
+            }
+        }
+        std::shuffle(connections.begin(), connections.end(), generator);
+        
+        int extraActivationUpdates = i % 3;
+        bool signedActivation = i % 2 == 0;
+        bool activated = i % 5 == 0;
+        CompiledNetwork compiled(nodes, connections, extraActivationUpdates, signedActivation, false);
+        ASSERT_TRUE(compiled.isCompiled());
+        BatchedNetwork batched(compiled);
+        ASSERT_TRUE(batched.isBatchable());
+        ReferenceNetwork reference(nodes, connections, extraActivationUpdates, signedActivation);
+        
+        int width = 2 + generator() % 8;
+        int height = 2 + generator() % 8;
+        std::vector<double> xInputs, yInputs;
+        for (int cellX = 0; cellX < width; cellX++)
+        {
+            for (int cellY = 0; cellY < height; cellY++)
+            {
+                xInputs.push_back(cellX - (width - 1) / 2.0);
+                yInputs.push_back(cellY - (height - 1) / 2.0);
+            }
+        }
+        
+        reference.setValue(BIAS, 1);
+        reference.setActivated(activated);
+        compiled.setValue(compiled.getSlot(INPUT_BIAS), 1);
+        compiled.setActivated(activated);
+        batched.setValue(INPUT_BIAS, 1);
+        batched.setValues(INPUT_X, xInputs);
+        batched.setValues(INPUT_Y, yInputs);
+        batched.setActivated(activated);
+        
+        // a second pass starts from the state the first one left
+        for (int pass = 0; pass < 2; pass++)
+        {
+            batched.update(xInputs.size());
+            for (size_t k = 0; k < xInputs.size(); k++)
+            {
+                reference.setValue(X, xInputs[k]);
+                reference.setValue(Y, yInputs[k]);
+                reference.update();
+                compiled.setValue(compiled.getSlot(INPUT_X), xInputs[k]);
+                compiled.setValue(compiled.getSlot(INPUT_Y), yInputs[k]);
+                compiled.update();
+                ASSERT_NEAR(reference.getValue(OUTPUT_ID), compiled.getValue(compiled.getSlot(OUTPUT)), BatchedNetwork::TOLERANCE);
+                ASSERT_NEAR(reference.getValue(OUTPUT_ID), batched.getValue(OUTPUT, k), BatchedNetwork::TOLERANCE);
+            }
+        }
+    }
+    
+    // a cycle, or the ones' complement, is left to FastNetwork
+    std::vector<CompiledNetwork::Node> nodes;
+    CompiledNetwork::Node input = {0, INPUT_X, true, ACTIVATION_FUNCTION_LINEAR};
+    CompiledNetwork::Node first = {1, "First", false, ACTIVATION_FUNCTION_SIN};
+    CompiledNetwork::Node second = {2, OUTPUT, false, ACTIVATION_FUNCTION_SIGMOID};
+    nodes.push_back(input);
+    nodes.push_back(first);
+    nodes.push_back(second);
+    std::vector<CompiledNetwork::Connection> connections;
+    CompiledNetwork::Connection forward = {1, 2, 1};
+    CompiledNetwork::Connection backward = {2, 1, 1};
+    connections.push_back(forward);
+    ASSERT_TRUE(CompiledNetwork(nodes, connections, 0, true, false).isCompiled());
+    connections.push_back(backward);
+    ASSERT_FALSE(CompiledNetwork(nodes, connections, 0, true, false).isCompiled());
+    connections.pop_back();
+    nodes[1].function = ACTIVATION_FUNCTION_ONES_COMPLIMENT;
+    ASSERT_FALSE(BatchedNetwork(CompiledNetwork(nodes, connections, 0, true, false)).isBatchable());
+}
+
+/**
+ * Evaluates mutated body genomes on a grid of cells, one cell after the other with FastNetwork
+ * and CompiledNetwork and all at once with BatchedNetwork, and compares the outputs and the time per grid.
+ */
+TEST(CppnEvaluators, MatchFastNetwork) {
+    const int SIZE = 12;
+    const int GENOMES = 50;
+    double fastSeconds = 0;
+    double compiledSeconds = 0;
+    double batchedSeconds = 0;
+    double worst = 0;
+    for (int i = 0; i < GENOMES; i++)
+    {
+        CppnGenome genome(SIZE);
+        for (int j = 0; j < 20; j++)
+        {
+            genome.mutate();
+        }
+        
+        std::vector<double> xInputs, yInputs, expected;
+        auto start = std::chrono::high_resolution_clock::now();
+        NEAT::FastNetwork<double> fast = genome.getCppn()->spawnFastPhenotypeStack<double>();
+        fast.setValue(INPUT_BIAS, 1);
+        for (int x = 0; x < SIZE; x++)
+        {
+            for (int y = 0; y < SIZE; y++)
+            {
+                fast.setValue(INPUT_X, x - SIZE / 2);
+                fast.setValue(INPUT_Y, y - SIZE / 2);
+                fast.update();
+                expected.push_back(fast.getValue(OUTPUT));
+                xInputs.push_back(x - SIZE / 2);
+                yInputs.push_back(y - SIZE / 2);
+            }
+        }
+        fastSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        
+        start = std::chrono::high_resolution_clock::now();
+        CompiledNetwork compiled(genome.getCppn());
+        ASSERT_TRUE(compiled.isCompiled());
+        int xInput = compiled.getSlot(INPUT_X);
+        int yInput = compiled.getSlot(INPUT_Y);
+        int output = compiled.getSlot(OUTPUT);
+        compiled.setValue(compiled.getSlot(INPUT_BIAS), 1);
+        std::vector<double> compiledValues;
+        for (size_t k = 0; k < expected.size(); k++)
+        {
+            compiled.setValue(xInput, xInputs[k]);
+            compiled.setValue(yInput, yInputs[k]);
+            compiled.update();
+            compiledValues.push_back(compiled.getValue(output));
+        }
+        compiledSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        
+        start = std::chrono::high_resolution_clock::now();
+        BatchedNetwork batched(genome.getCppn());
+        ASSERT_TRUE(batched.isBatchable());
+        batched.setValue(INPUT_BIAS, 1);
+        batched.setValues(INPUT_X, xInputs);
+        batched.setValues(INPUT_Y, yInputs);
+        batched.update(expected.size());
+        batchedSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        
+        for (size_t k = 0; k < expected.size(); k++)
+        {
+            ASSERT_NEAR(expected[k], compiledValues[k], BatchedNetwork::TOLERANCE);
+            ASSERT_NEAR(expected[k], batched.getValue(OUTPUT, k), BatchedNetwork::TOLERANCE);
+            worst = std::max(worst, std::fabs(expected[k] - compiledValues[k]));
+            worst = std::max(worst, std::fabs(expected[k] - batched.getValue(OUTPUT, k)));
+        }
+    }
+    std::cout << SIZE << "x" << SIZE << " grid: FastNetwork " << fastSeconds / GENOMES * 1e6 << "us, CompiledNetwork "
+              << compiledSeconds / GENOMES * 1e6 << "us, BatchedNetwork "
+              << batchedSeconds / GENOMES * 1e6 << "us, largest difference " << worst << std::endl;
+}
+
+TEST(RoombotBuildPlan, NeighboursAndConnectors) {
+    // an L of two modules: cells (0,0) (1,0) and (2,0) (2,1)
+    RoombotBuildPlan plan(5);
+    plan.add(0, 0, true);
+    plan.add(2, 0, false);
+    ASSERT_EQ(2, plan.numberOfNeighbours(1, 1));
+    ASSERT_EQ(1, plan.numberOfNeighbours(3, 0));
+    ASSERT_EQ(0, plan.numberOfNeighbours(4, 4));
+    ASSERT_EQ(3, plan.numberOfNeighbours(0, 1, true));
+    ASSERT_TRUE(plan.getConnector(0, NORTH_CONNECTOR));
+    ASSERT_FALSE(plan.getConnector(0, SOUTH_CONNECTOR));
+    
+    // the same L turned clockwise, which is compared by turning it
+    RoombotBuildPlan turned(5);
+    turned.add(0, 0, false);
+    turned.add(0, -1, true);
+    ASSERT_TRUE(plan.equalOrganisms(&turned));
+    ASSERT_FALSE(plan.equalOrganisms(&turned, false, false));
+    ASSERT_EQ(2, turned.numberOfNeighbours(1, 0));
+}
+
 TEST(RandomGeneration, BinomialDistribution) {
     NEAT::Globals::init();
     NEAT::Random random = NEAT::Globals::getSingleton()->getRandom();
@@ -129,6 +1774,8 @@ TEST(Logging, FileLogger){
 int main(int argc, const char * argv[])
 {
     testing::InitGoogleTest(&argc, (char**)argv);
-    return RUN_ALL_TESTS();
+    int result = RUN_ALL_TESTS();
+    boost::filesystem::remove_all(temporaryDirectory());
+    return result;
 }
 
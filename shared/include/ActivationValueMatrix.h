@@ -1,12 +1,16 @@
 #ifndef OM_ACTIVATION_VALUE_MATRIX_H_
 #define OM_ACTIVATION_VALUE_MATRIX_H_
 
+#include "BatchedNetwork.h"
+#include "CompiledNetwork.h"
 #include "Defines.h"
 #include "ParametersReader.h"
 
 #include "NEAT.h"
 #include <boost/numeric/ublas/matrix.hpp>
+#include <queue>
 #include <set>
+#include <vector>
 
 using namespace boost::numeric::ublas;
 
@@ -57,6 +61,12 @@ class Coordinate
  * When querying the matrix the input X and Y values are modified such that the center of the matrix corresponds to (0,0)
  * The modified X' and Y' values are then set as input for the X and Y inputs of the CPPN network.
  * The output of the network will then be returned as the activation value for the original X and Y query.
+ * The network is queried once for every cell when the matrix is constructed, column by column,
+ * and the values are stored, so that searching the matrix does not run the network again.
+ * With CPPN_EVALUATOR set to COMPILED the cells are evaluated one by one by a CompiledNetwork,
+ * and with BATCHED all at once by a BatchedNetwork, whose values differ from those of FastNetwork
+ * by less than BatchedNetwork::TOLERANCE; genomes they cannot evaluate are queried with FastNetwork.
+ * A matrix can also be constructed from values evaluated beforehand.
  *
  * For example, a matrix with a width and height of two will contain the activation values of
  * (-0.5, -0.5), (0.5, -0.5), (-0.5, 0.5) and (0.5, 0.5) in the cells
@@ -68,6 +78,9 @@ class Coordinate
  * and it keeps track of all coorindate that are adjacent to the current organism,
  * added to the Activation Value Matrix via the addModuleCoordinate function,
  * which are the only cells that need to be considered while extending the organism.
+ * These adjacent cells are kept in a heap ordered by activation value, so that finding the best one
+ * does not scan all of them: cells leaving the adjacent cells are only removed from the heap
+ * once they reach its top.
  */
 class ActivationValueMatrix
 {
@@ -75,21 +88,47 @@ class ActivationValueMatrix
 	int height;                             //The height of the matrix
 	double xModifier;                       //Modifier to substract from the X value to get the input value of the X input node
 	double yModifier;                       //Modifier to substract from the Y value to get the input value of the Y input node
-	mutable NEAT::FastNetwork<double> cppn; //The CPPN used to generate the matrix values.
-    //Made mutable because the `changes' made do not actually change the state of the activation value matrix.
+	std::vector<double> values;             //The activation values produced by the CPPN, cell (X,Y) at X * height + Y.
 	matrix<bool>* used;                     //Boolean matrix indicating which cells have been set to `used'
-	set<Coordinate> adjacentCoordinates;	//The complete set of coordinates adjacent to the current organism.
+	
+	/**
+	 * A cell adjacent to the current organism, ordered by activation value and, for equal values,
+	 * by coordinate the other way around, so that the top of a heap is the cell with the highest value
+	 * that comes first in Coordinate order.
+	 */
+	struct Candidate
+	{
+		double value;
+		int x;
+		int y;
+		
+		bool operator<(const Candidate &other) const;
+	};
+	
+	std::vector<char> adjacent;                         //Whether cell (X,Y) is adjacent to the current organism, at X * height + Y.
+	mutable std::priority_queue<Candidate> candidates;  //The adjacent cells above THRESHOLD, possibly with cells no longer adjacent.
     
     public:
     
 	/**
-	 * Constructs an activation value matrix for the supplied genome, width and height.
+	 * Constructs an activation value matrix for the supplied genome, width and height,
+	 * activating the CPPN once for every cell.
 	 *
 	 * @param genome The genome used to construct the CPPN that supplies the values for the matrix.
 	 * @param _width The width of the Activation Value Matrix.
 	 * @param _height The height of the Activation Value Matrix.
+	 * @param evaluator How the CPPN is evaluated, one of the values of CPPN_EVALUATOR.
+	 */
+	ActivationValueMatrix(boost::shared_ptr<const NEAT::GeneticIndividual> genome, int width, int height, const std::string & evaluator);
+	
+	/**
+	 * Constructs an activation value matrix of values that were already evaluated.
+	 *
+	 * @param values The activation value of every cell, cell (X,Y) at X * height + Y.
+	 * @param _width The width of the Activation Value Matrix.
+	 * @param _height The height of the Activation Value Matrix.
 	 */
-	ActivationValueMatrix(boost::shared_ptr<const NEAT::GeneticIndividual> genome, int width, int height);
+	ActivationValueMatrix(const std::vector<double> & values, int width, int height);
     
 	/**
 	 * Destructs the Activation Value Matrix.
@@ -107,7 +146,7 @@ class ActivationValueMatrix
 	 * it will return the Coordinate of the cell with the highest activation value among them.
 	 * Else it will return a Coordinate where found is false and x, y and value have no meaning.
 	 */
-	Coordinate getMax() const;
+	virtual Coordinate getMax() const;
     
 	/**
 	 * Returns the Coordinate of the cell with the highest activation value in the Activation Value Matrix,
@@ -120,7 +159,7 @@ class ActivationValueMatrix
 	 * it will return the Coordinate of the cell with the highest activation value among them.
 	 * Else it will return a Coordinate where found is false and x, y and value have no meaning.
 	 */
-	Coordinate getMaxNeighbour(const Coordinate& coordinate) const;
+	virtual Coordinate getMaxNeighbour(const Coordinate& coordinate) const;
     
 	/**
 	 * Returns the Coordinate of the cell with the highest activation value in the Activation Value Matrix,
@@ -133,7 +172,7 @@ class ActivationValueMatrix
 	 * it will return the Coordinate of the cell with the highest activation value among them.
 	 * Else it will return a Coordinate where found is false and x, y and value have no meaning.
 	 */
-	Coordinate getMaxAdjacent() const;
+	virtual Coordinate getMaxAdjacent() const;
     
 	/**
 	 * Sets the cell indicated by coordinate to the new used value.
@@ -143,7 +182,7 @@ class ActivationValueMatrix
 	 * @param newUsed The new value for used, where true means the cell is used and will be omitted,
 	 * while false means the cell is free and should be considered for all purposes.
 	 */
-	void setUsed(const Coordinate& coordinate, bool newUsed);
+	virtual void setUsed(const Coordinate& coordinate, bool newUsed);
     
 	/**
 	 * `Adds' a module to coordinate.
@@ -157,14 +196,41 @@ class ActivationValueMatrix
 	 *
 	 * @param coordinate The coordinate that will be considered occupied by the module.
 	 */
-	void addModuleCoordinate(const Coordinate& coordinate);
+	virtual void addModuleCoordinate(const Coordinate& coordinate);
+    
+	int getWidth() const;
+    
+	int getHeight() const;
     
     
     
-    private:
+    protected:
     
     double THRESHOLD = ParametersReader::get<double>("THRESHOLD");
 	
+	/**
+	 * Fills values by setting the inputs of a FastNetwork and updating it for every cell.
+	 *
+	 * @param genome The genome used to construct the CPPN.
+	 */
+	void evaluate(boost::shared_ptr<const NEAT::GeneticIndividual> genome);
+	
+	/**
+	 * Fills values like evaluate(), with a CompiledNetwork.
+	 *
+	 * @param genome The genome used to construct the CPPN.
+	 * @return Returns false, without changing values, if the network of the genome cannot be compiled.
+	 */
+	bool evaluateCompiled(boost::shared_ptr<const NEAT::GeneticIndividual> genome);
+	
+	/**
+	 * Fills values by updating a BatchedNetwork once with the inputs of all cells.
+	 *
+	 * @param genome The genome used to construct the CPPN.
+	 * @return Returns false, without changing values, if the network of the genome cannot be batched.
+	 */
+	bool evaluateBatched(boost::shared_ptr<const NEAT::GeneticIndividual> genome);
+	
     /**
 	 * Indicates whether a cell has been `used'.
 	 *
@@ -0,0 +1,95 @@
+#ifndef shared_AngleFrame_h
+#define shared_AngleFrame_h
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * Fixed layout frame used by the modules of an organism to exchange motor angles every time step:
+ *
+ *   magic "AF" (2 bytes), type (uint8), reserved (uint8),
+ *   module index (uint16), number of modules (uint16), angles per module (uint16), reserved (uint16),
+ *   timestamp (double),
+ *   angles (double), module after module
+ *
+ * A COMMAND frame is sent by the root and carries the next angles of every module,
+ * an INFORM frame is sent by a module and carries its current angles only.
+ * Frames never leave the simulation, so numbers are stored in host byte order.
+ *
+ * Encoding writes into a buffer owned by the caller and decoding reads the packet in place,
+ * so neither allocates once the buffers have their final size.
+ */
+class AngleFrame
+{
+public:
+
+    enum Type : uint8_t
+    {
+        COMMAND = 1,
+        INFORM = 2
+    };
+
+    static const size_t HEADER_SIZE_BYTES = 20;
+
+    /**
+     * @return The size in bytes of a frame with the given number of angles.
+     */
+    static size_t getSize(size_t modulesCount, size_t anglesCount);
+
+    /**
+     * Encodes the angles of all the modules, as sent by the root.
+     * The buffer is only resized when it is too small.
+     *
+     * @return The size of the encoded frame.
+     */
+    static size_t encodeCommand(std::vector<char> & buffer, double timestamp, const std::vector<std::vector<double> > & angles);
+
+    /**
+     * Encodes the angles of a single module, as sent to the root.
+     *
+     * @return The size of the encoded frame.
+     */
+    static size_t encodeInform(std::vector<char> & buffer, double timestamp, size_t moduleIndex, const std::vector<double> & angles);
+
+    /**
+     * Reads a received packet in place. Packets that are not angle frames,
+     * or whose size does not match their header, are marked invalid.
+     */
+    AngleFrame(const void * data, size_t size);
+
+    bool isValid() const;
+
+    Type getType() const;
+
+    double getTimestamp() const;
+
+    size_t getModuleIndex() const;
+
+    size_t getModulesCount() const;
+
+    size_t getAnglesCount() const;
+
+    /**
+     * @param module Index of the module inside the frame, always 0 for INFORM frames.
+     */
+    double getAngle(size_t module, size_t angle) const;
+
+    /**
+     * Copies the angles of a module into an existing vector, up to the size of the vector.
+     */
+    void copyAngles(size_t module, std::vector<double> & angles) const;
+
+private:
+
+    const char * data;
+    bool valid;
+    Type type;
+    double timestamp;
+    size_t moduleIndex;
+    size_t modulesCount;
+    size_t anglesCount;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef shared_BatchedNetwork_h
+#define shared_BatchedNetwork_h
+
+#include "CompiledNetwork.h"
+
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+
+/**
+ * Evaluates the network of a genome on many input vectors at once, giving the same values
+ * FastNetwork<double> would give when the vectors are set and updated one after the other.
+ *
+ * FastNetwork updates all nodes at the same time: during an update a node reads the values its
+ * inputs had after the previous update, so a hidden node queried at sample k sees what its
+ * inputs computed for sample k - 1, and the input nodes the values set for sample k. The values
+ * of every node are kept in a structure of arrays, one array per node with one element per sample,
+ * and the instructions of a CompiledNetwork are run in their topological order: the inputs of a node
+ * at sample k - 1 are then all known when the node is evaluated, and summing its links is a
+ * multiply-add of whole arrays, which is vectorised with AVX or SSE2 when the compiler targets them.
+ *
+ * The sums of the links are done in the same order as FastNetwork does, so values only differ
+ * by the rounding of the activation functions and of contracted multiply-adds, less than TOLERANCE.
+ * Networks that cannot be compiled cannot be evaluated this way either: isBatchable() is false
+ * and they have to be run with FastNetwork.
+ */
+class BatchedNetwork
+{
+public:
+
+    /**
+     * Largest difference with the values of FastNetwork<double> on the same inputs.
+     */
+    static const double TOLERANCE;
+
+    /**
+     * Builds the network of the genome, with every node at 0 and not activated, like
+     * GeneticIndividual::spawnFastPhenotypeStack() does.
+     */
+    explicit BatchedNetwork(boost::shared_ptr<const NEAT::GeneticIndividual> genome);
+
+    /**
+     * Builds the network of a compiled network, with every node at 0 and not activated.
+     */
+    explicit BatchedNetwork(const CompiledNetwork & compiled);
+
+    bool isBatchable() const;
+
+    bool hasNode(const std::string & node) const;
+
+    /**
+     * Sets the same value of an input node for every sample.
+     */
+    void setValue(const std::string & node, double value);
+
+    /**
+     * Sets the value of an input node for each sample. Samples beyond the end of values
+     * keep the last value.
+     */
+    void setValues(const std::string & node, const std::vector<double> & values);
+
+    /**
+     * Updates the network once for every sample, in order, as FastNetwork::update() would.
+     * The state left by the last sample is where the next update() starts from.
+     * If the network is not activated, the first sample is updated 1 + ExtraActivationUpdates
+     * more times, as FastNetwork does on its first update.
+     *
+     * @param samples The number of samples, at least 1.
+     */
+    void update(size_t samples);
+
+    /**
+     * @return The value of the node after the update of the sample.
+     */
+    double getValue(const std::string & node, size_t sample) const;
+
+    /**
+     * Sets every node back to 0 and the network to not activated.
+     */
+    void reinitialize();
+
+    void setActivated(bool value);
+
+    size_t getSamplesCount() const;
+
+private:
+
+    /**
+     * Updates samples 0 .. count - 1 once, starting from the state in slot 0 of every node,
+     * and leaves the values of the last sample as state.
+     */
+    void iterate(size_t count);
+
+    /**
+     * Resizes the arrays of the nodes to hold the samples, keeping the state.
+     */
+    void reserve(size_t samples);
+
+    int getSlot(const std::string & node) const;
+
+    CompiledNetwork network;
+    std::vector<std::vector<double> > inputValues;  //The values set for each input node, the last one for the remaining samples.
+    std::vector<double> values;                     //Node n at n * stride, its state first and then one value per sample.
+    size_t stride;
+    size_t samplesCount;
+    bool activated;
+};
+
+#endif
@@ -19,6 +19,25 @@ class Builder
     
     std::auto_ptr<BuildPlan> translateGenome(CppnGenome genome) const;
     
+    /**
+     * Tells whether the build plan of the genome would have at least the given number of modules.
+     * The translation is the one of translateGenome(), step by step, but it stops as soon as the
+     * answer is known instead of growing the whole body.
+     * The matrix activates the CPPN once for every cell, which the search for the first module needs
+     * anyway since it reads the whole grid: stopping early saves growth steps, not CPPN activations.
+     */
+    bool hasModules(CppnGenome genome, size_t modules) const;
+    
+    /**
+     * Translates the activation values of a matrix, as translateGenome() does with the matrix of the CPPN
+     * of a genome, until the build plan has maximumModules modules or cannot grow any more.
+     */
+    static std::auto_ptr<BuildPlan> translate(ActivationValueMatrix & matrix, size_t maximumModules);
+    
+    private:
+    
+    std::string CPPN_EVALUATOR = ParametersReader::get<std::string>("CPPN_EVALUATOR");
+    
 };
 
 #endif
@@ -0,0 +1,57 @@
+#ifndef shared_ChannelTraffic_h
+#define shared_ChannelTraffic_h
+
+#include <map>
+#include <string>
+
+
+/**
+ * Counters of the packets sent and received by a controller, per radio channel.
+ *
+ * The counters cover the interval since the last store(), which appends one line per channel
+ * to a results file shared by all the controllers:
+ *
+ *   #time source channel sent_packets sent_bytes received_packets received_bytes largest_packet max_queue mean_queue
+ *
+ * where the queue columns are the receiver queue lengths sampled once per step.
+ */
+class ChannelTraffic
+{
+public:
+
+    void countSent(int channel, size_t bytes);
+
+    void countReceived(int channel, size_t bytes);
+
+    /**
+     * Samples the length of the receiver queue of a channel, to be called once per step.
+     */
+    void countQueueLength(int channel, int length);
+
+    /**
+     * Appends the counters to the file and starts a new interval.
+     *
+     * @param source Name of the controller, e.g. "evolver" or the name of a robot.
+     */
+    void store(const std::string & path, const std::string & source, double time);
+
+    void reset();
+
+private:
+
+    struct Counters
+    {
+        unsigned long sentPackets = 0;
+        unsigned long sentBytes = 0;
+        unsigned long receivedPackets = 0;
+        unsigned long receivedBytes = 0;
+        size_t largestPacket = 0;
+        int maxQueueLength = 0;
+        unsigned long queueLengthSum = 0;
+        unsigned long queueSamples = 0;
+    };
+
+    std::map<int, Counters> channels;
+};
+
+#endif
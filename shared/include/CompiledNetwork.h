@@ -0,0 +1,145 @@
+#ifndef shared_CompiledNetwork_h
+#define shared_CompiledNetwork_h
+
+#include "NEAT.h"
+
+#include <boost/shared_ptr.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+
+/**
+ * The network of a genome compiled to a straight list of instructions, giving the same values
+ * as FastNetwork<double> without looking up node names or activation functions while running.
+ *
+ * Every node of the genome gets an integer slot, looked up once with getSlot(). Every node that is
+ * updated gets one instruction: the slot it writes, its links as (source slot, weight) pairs stored
+ * one after the other, and its activation function, resolved with the signed activation and tanh
+ * settings of NEAT::Globals when the network is compiled. Instructions are in topological order,
+ * every node after the nodes it reads.
+ *
+ * FastNetwork updates all nodes at the same time, every node reading the values of the previous
+ * update. update() runs the instructions in reverse order, so that the nodes a node reads are
+ * updated after it and still hold their previous values: values are updated in place and the
+ * links are summed in the same order as FastNetwork does, so the results are the same up to the
+ * rounding of the activation functions.
+ *
+ * Networks with cycles, or with the ones' complement activation function, cannot be compiled:
+ * isCompiled() is false and they have to be run with FastNetwork.
+ */
+class CompiledNetwork
+{
+public:
+
+    /**
+     * An activation function, applied to the sum of the links of a node.
+     */
+    typedef double (*Activation)(double);
+
+    struct Link
+    {
+        int source;
+        double weight;
+    };
+
+    struct Instruction
+    {
+        int target;
+        Activation activation;
+        size_t firstLink;
+        size_t linksCount;
+    };
+
+    /**
+     * A node gene of a genome.
+     */
+    struct Node
+    {
+        int id;
+        std::string name;
+        bool input;
+        ActivationFunction function;
+    };
+
+    /**
+     * A link gene of a genome, between the nodes with the given ids.
+     */
+    struct Connection
+    {
+        int from;
+        int to;
+        double weight;
+    };
+
+    /**
+     * Compiles the network of the genome, with every node at 0 and not activated, like
+     * GeneticIndividual::spawnFastPhenotypeStack() does.
+     */
+    explicit CompiledNetwork(boost::shared_ptr<const NEAT::GeneticIndividual> genome);
+
+    /**
+     * Compiles the network of the node and link genes of a genome, in the order of the genome,
+     * with the settings NEAT::Globals would give.
+     */
+    CompiledNetwork(const std::vector<Node> & nodes, const std::vector<Connection> & connections, int extraActivationUpdates, bool signedActivation, bool usingTanhSigmoid);
+
+    bool isCompiled() const;
+
+    /**
+     * @return The slot of the node, or -1 if the genome has no such node.
+     */
+    int getSlot(const std::string & node) const;
+
+    size_t getSlotsCount() const;
+
+    /**
+     * @return True if the slot belongs to an input node, which keeps the value it is set to.
+     */
+    bool isInput(int slot) const;
+
+    void setValue(int slot, double value);
+
+    double getValue(int slot) const;
+
+    /**
+     * Updates the network once, as FastNetwork::update() would: if the network is not activated,
+     * it is updated 1 + ExtraActivationUpdates more times.
+     */
+    void update();
+
+    /**
+     * Sets every node back to 0 and the network to not activated.
+     */
+    void reinitialize();
+
+    void setActivated(bool value);
+
+    /**
+     * @return The number of times the network is updated by the first update() after construction
+     * or reinitialize(), besides the update itself.
+     */
+    int getActivationUpdates() const;
+
+    const std::vector<Instruction> & getInstructions() const;
+
+    const std::vector<Link> & getLinks() const;
+
+private:
+
+    /**
+     * Runs every instruction once.
+     */
+    void iterate();
+
+    std::vector<Instruction> instructions;
+    std::vector<Link> links;
+    std::vector<double> values;
+    std::vector<char> inputs;
+    std::map<std::string, int> slots;
+    bool compiled;
+    bool activated;
+    int activationUpdates;
+};
+
+#endif
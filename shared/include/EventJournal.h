@@ -0,0 +1,79 @@
+#ifndef shared_EventJournal_h
+#define shared_EventJournal_h
+
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Appends text to results files from a background thread.
+ *
+ * Text written to a file is kept in a buffer of that file and appended by the writer thread,
+ * which keeps the files open, so writing an event costs neither opening nor closing a file.
+ * Text is appended in the order it was written, exactly as given.
+ *
+ * Buffers are written when the writer is woken up every flush interval, when flush() is called
+ * and when the journal is destroyed. While more than the maximum size is buffered, write() waits
+ * for the writer, so memory stays bounded even if the disk is slower than the simulation.
+ */
+class EventJournal
+{
+public:
+
+    /**
+     * @param maximumBufferedSize Size in bytes of the buffered text above which write() waits.
+     * @param flushInterval Seconds of wall clock time between two writes of the buffers.
+     */
+    EventJournal(size_t maximumBufferedSize, double flushInterval);
+
+    /**
+     * Writes what is still buffered and stops the writer.
+     */
+    ~EventJournal();
+
+    /**
+     * Appends text to a file, creating it if needed.
+     *
+     * @param header Written before the text if the file does not exist yet when it is first
+     * written by this journal, e.g. the description of its columns.
+     */
+    void write(const std::string & path, const std::string & text, const std::string & header = "");
+
+    /**
+     * Waits until everything written so far is in the files.
+     */
+    void flush();
+
+    size_t getBufferedSize();
+
+private:
+
+    struct File
+    {
+        std::string path;
+        std::ofstream stream;
+        std::string buffer;
+    };
+
+    void work();
+
+    std::map<std::string, std::unique_ptr<File> > files;
+    std::vector<File *> order;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable written;
+    std::thread writer;
+    const size_t maximumBufferedSize;
+    const double flushInterval;
+    size_t bufferedSize;
+    bool flushing;
+    bool stopping;
+};
+
+#endif
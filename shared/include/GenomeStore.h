@@ -0,0 +1,156 @@
+#ifndef shared_GenomeStore_h
+#define shared_GenomeStore_h
+
+#include "Message.h"
+#include "MessageView.h"
+
+#include <limits>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+
+/**
+ * Content-addressed store of body and mind genomes, keyed by the SHA-256 digest of their text.
+ *
+ * Genome-bearing messages carry the digest of every genome in a "<FIELD>_DIGEST" field,
+ * and the full text in "<FIELD>" only when the receivers may not know it yet.
+ * Receivers keep every genome text they see, and look up the ones that came as a digest only.
+ * Messages from controllers that do not know about digests always carry the full text,
+ * which resolve() accepts as well.
+ *
+ * Genomes that are held, e.g. those of the live organisms, stay in the store until they are released.
+ * Of the other genomes, at most a fixed number are kept, dropping the least recently stored or resolved
+ * ones first; a genome that is dropped is also forgotten as sent, so add() sends its full text again.
+ */
+class GenomeStore
+{
+public:
+
+    /**
+     * @param capacity Maximum number of genomes kept besides the held ones.
+     */
+    explicit GenomeStore(size_t capacity = std::numeric_limits<size_t>::max());
+
+    /**
+     * @return The SHA-256 digest of the content, as 64 hexadecimal characters.
+     */
+    static std::string digest(boost::string_ref content);
+
+    /**
+     * Stores a genome.
+     *
+     * @return The digest of the genome.
+     */
+    std::string put(boost::string_ref content);
+
+    /**
+     * Stores a genome that was received together with its digest.
+     *
+     * @return False, without storing it, if the content does not match the digest,
+     *         or the genome already stored with this digest.
+     */
+    bool put(boost::string_ref digest, boost::string_ref content);
+
+    /**
+     * @return The genome with the given digest, or NULL if it is not in the store.
+     */
+    const std::string * find(boost::string_ref digest) const;
+
+    bool contains(boost::string_ref digest) const;
+
+    /**
+     * Keeps the genome in the store until it is released as many times as it was held.
+     *
+     * @return False if the genome is not in the store.
+     */
+    bool hold(boost::string_ref digest);
+
+    /**
+     * Releases a genome held with hold(). Once no longer held it can be dropped from the store.
+     */
+    void release(boost::string_ref digest);
+
+    /**
+     * @return The number of genomes in the store, held or not.
+     */
+    size_t size() const;
+
+    /**
+     * Adds the digest and the full text of a genome to a message.
+     */
+    void addFull(Message & message, const std::string & field, const std::string & content);
+
+    /**
+     * Adds only the digest of a genome to a message, for receivers that are known to have it.
+     */
+    void addDigest(Message & message, const std::string & field, const std::string & content);
+
+    /**
+     * Adds the digest of a genome to a message, and its full text the first time
+     * the genome is sent on the channel. Only for channels whose receivers ask for the genomes
+     * they dropped, as the robots do; the evolver does not, so it is always sent the full text.
+     */
+    void add(Message & message, const std::string & field, const std::string & content, int channel);
+
+    /**
+     * Makes the next add() on the channel send the full text of every genome again,
+     * e.g. because a receiver asked for a genome it did not have.
+     */
+    void forgetSent(int channel);
+
+    /**
+     * Reads a genome field of a received message, storing its text if it was sent in full.
+     * A text that does not match the digest sent with it is trusted, as it would be from a sender
+     * without a store, and stored under its own digest.
+     *
+     * @param content Set to the genome text when the genome is known.
+     * @param contentDigest Set to the digest the text is stored under when the genome is known,
+     *        or to the digest that could not be found.
+     * @return False if the message only carries a digest which is not in the store.
+     */
+    bool resolve(const MessageView & message, const std::string & field, std::string * content, std::string * contentDigest = NULL);
+
+    /**
+     * @return A request for the genome with the given digest.
+     */
+    static Message createRequest(const std::string & digest);
+
+    /**
+     * @return The answer to a request, or an UNKNOWN_MESSAGE if the genome is not in the store.
+     */
+    Message createContent(boost::string_ref digest) const;
+
+private:
+
+    struct Entry
+    {
+        std::string content;
+        unsigned int holders;
+        std::list<std::string>::iterator unheldPosition;
+    };
+
+    /**
+     * Stores a genome whose digest is known to match, or marks it as the most recently used.
+     */
+    void store(const std::string & key, boost::string_ref content);
+
+    /**
+     * Marks a genome that is not held as the most recently used.
+     */
+    void touch(Entry & entry);
+
+    /**
+     * Drops the least recently used genomes that are not held, down to the capacity.
+     */
+    void shrink();
+
+    size_t capacity;
+    std::unordered_map<std::string, Entry> genomes;
+    std::list<std::string> unheld;              //Digests of the genomes not held, the most recently used first.
+    std::map<int, std::set<std::string> > sent;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef shared_LocalRadio_h
+#define shared_LocalRadio_h
+
+#include "Radio.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+class LocalRadioBus;
+
+
+/**
+ * Emitter of a LocalRadioBus, placed at a position set by its owner.
+ */
+class LocalEmitter : public RadioEmitter
+{
+public:
+
+    LocalEmitter(LocalRadioBus & bus, int channel);
+
+    int send(const void * data, int size);
+
+    void setChannel(int channel);
+
+    int getChannel() const;
+
+    void setRange(double range);
+
+    double getRange() const;
+
+    void setPosition(double x, double y, double z);
+
+    const double * getPosition() const;
+
+private:
+
+    LocalRadioBus & bus;
+    int channel;
+    double range;
+    double position[3];
+};
+
+
+/**
+ * Receiver of a LocalRadioBus, with its own queue of delivered packets.
+ */
+class LocalReceiver : public RadioReceiver
+{
+public:
+
+    LocalReceiver(int channel);
+
+    const void * getData() const;
+
+    int getDataSize() const;
+
+    void nextPacket();
+
+    int getQueueLength() const;
+
+    void setChannel(int channel);
+
+    int getChannel() const;
+
+    void setPosition(double x, double y, double z);
+
+    const double * getPosition() const;
+
+    void deliver(const std::string & packet);
+
+private:
+
+    int channel;
+    double position[3];
+    std::deque<std::string> queue;
+};
+
+
+/**
+ * In-process stand-in for the Webots radio, to run and benchmark the messaging of the
+ * controllers without a simulation.
+ *
+ * It follows the Webots semantics: a packet reaches every receiver listening on the channel of
+ * the emitter (or on CHANNEL_BROADCAST, or sent on CHANNEL_BROADCAST) which is within the range
+ * of the emitter when it is sent, and it is only available to the receivers after the next step().
+ */
+class LocalRadioBus
+{
+public:
+
+    static const int CHANNEL_BROADCAST = -1;
+
+    /**
+     * Creates an emitter, owned by the bus.
+     */
+    LocalEmitter * createEmitter(int channel = 0);
+
+    /**
+     * Creates a receiver, owned by the bus.
+     */
+    LocalReceiver * createReceiver(int channel = 0);
+
+    /**
+     * Delivers the packets sent since the previous step.
+     */
+    void step();
+
+    unsigned long getSentPackets() const;
+
+    unsigned long getDeliveredPackets() const;
+
+private:
+
+    friend class LocalEmitter;
+
+    struct Packet
+    {
+        int channel;
+        double range;
+        double position[3];
+        std::string data;
+    };
+
+    void send(const LocalEmitter & emitter, const void * data, int size);
+
+    std::vector<std::unique_ptr<LocalEmitter> > emitters;
+    std::vector<std::unique_ptr<LocalReceiver> > receivers;
+    std::vector<Packet> inFlight;
+    unsigned long sentPackets = 0;
+    unsigned long deliveredPackets = 0;
+};
+
+#endif
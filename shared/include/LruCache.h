@@ -0,0 +1,98 @@
+#ifndef shared_LruCache_h
+#define shared_LruCache_h
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+
+/**
+ * Cache holding at most a fixed number of values, which drops the least recently used one
+ * when a value is added to a full cache.
+ */
+template<typename Key, typename Value>
+class LruCache
+{
+public:
+
+    /**
+     * @param capacity Maximum number of values, 0 to disable the cache.
+     */
+    LruCache(size_t capacity) : capacity(capacity), hits(0), misses(0)
+    {
+        //nix
+    }
+
+    /**
+     * @return The cached value, marked as the most recently used, or NULL if it is not in the cache.
+     */
+    Value * find(const Key & key)
+    {
+        typename std::unordered_map<Key, typename Entries::iterator>::iterator position = index.find(key);
+        if (position == index.end())
+        {
+            misses++;
+            return NULL;
+        }
+        hits++;
+        entries.splice(entries.begin(), entries, position->second);
+        return &position->second->second;
+    }
+
+    /**
+     * Adds a value, or replaces the value with the same key, as the most recently used.
+     */
+    void put(const Key & key, const Value & value)
+    {
+        if (capacity == 0)
+        {
+            return;
+        }
+        typename std::unordered_map<Key, typename Entries::iterator>::iterator position = index.find(key);
+        if (position != index.end())
+        {
+            entries.erase(position->second);
+            index.erase(position);
+        }
+        else if (entries.size() >= capacity)
+        {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        entries.push_front(std::make_pair(key, value));
+        index[key] = entries.begin();
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    void clear()
+    {
+        entries.clear();
+        index.clear();
+    }
+
+    unsigned long getHits() const
+    {
+        return hits;
+    }
+
+    unsigned long getMisses() const
+    {
+        return misses;
+    }
+
+private:
+
+    typedef std::list<std::pair<Key, Value> > Entries;
+
+    size_t capacity;
+    unsigned long hits;
+    unsigned long misses;
+    Entries entries;
+    std::unordered_map<Key, typename Entries::iterator> index;
+};
+
+#endif
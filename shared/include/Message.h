@@ -0,0 +1,172 @@
+#ifndef shared_Message_h
+#define shared_Message_h
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <boost/utility/string_ref.hpp>
+
+class MessageView;
+
+
+/**
+ * Types of the messages exchanged between the controllers.
+ * The numeric value is what travels on the wire, so new types must only be appended.
+ */
+enum MessageType : uint16_t
+{
+    UNKNOWN_MESSAGE = 0,
+    ENVIRONMENT_OK_MESSAGE,
+    GENOME_TO_CLINIC_MESSAGE,
+    ORGANISM_BUILT_MESSAGE,
+    UPDATE_AVAILABLE_MESSAGE,
+    REBUILD_MESSAGE,
+    DEATH_ANNOUNCEMENT_MESSAGE,
+    ADULT_ANNOUNCEMENT,
+    FERTILE_ANNOUNCEMENT,
+    FITNESS_UPDATE,
+    COUPLE_MESSAGE,
+    GENOME_SPREAD_MESSAGE,
+    TO_RESERVE_MESSAGE,
+    ENERGY_UPDATE,
+    CONNECTORS_PROBLEM_MESSAGE,
+    CYLINDER_PROBLEM_MESSAGE,
+    GENOME_REQUEST_MESSAGE,
+    GENOME_CONTENT_MESSAGE,
+    BATCH_MESSAGE,              // several messages sent in one packet, each encoded in a "RECORD" field
+    MESSAGE_TYPES_COUNT
+};
+
+
+/**
+ * A typed message with named fields, encoded in a length-prefixed binary format:
+ *
+ *   header      magic "\x7fTOL", version (uint8), reserved (uint8), type (uint16),
+ *               number of fields (uint16), reserved (uint16), payload size (uint32)
+ *   field table one entry per field: name length (uint16), reserved (uint16),
+ *               offset of the name in the payload (uint32), value length (uint32)
+ *   payload     name and value bytes of every field, the value directly after its name
+ *
+ * All integers are little endian. Since every value is delimited by its length
+ * genomes and other payloads may contain any byte, including the old field markers.
+ *
+ * The first reserved byte of the header holds flags. With FLAG_COMPRESSED set, the field table
+ * and the payload are replaced by their size (uint32) followed by their zlib compression, and
+ * the payload size in the header is the size of this block. Whether a message is compressed is
+ * decided by the compression threshold of its type, see setCompressionThreshold().
+ *
+ * Packets that do not start with the magic are decoded as the old text format
+ * "[TYPE]*FIELDvalueFIELD*...", so controllers of different versions can still talk.
+ */
+class Message
+{
+public:
+
+    /**
+     * Creates an empty message of the given type.
+     */
+    Message(MessageType type = UNKNOWN_MESSAGE);
+
+    /**
+     * Copies the content of a received packet, so that it can be kept after the packet is released.
+     */
+    explicit Message(const MessageView & view);
+
+    /**
+     * Decodes a received packet, either in the binary or in the old text format,
+     * copying its content so that it can be kept after the packet is released.
+     * A malformed packet results in an UNKNOWN_MESSAGE without fields.
+     *
+     * @param data The packet data, as returned by Receiver::getData().
+     * @param size The packet size, as returned by Receiver::getDataSize().
+     */
+    static Message decode(const void * data, size_t size);
+
+    /**
+     * Appends a field to the message.
+     *
+     * @return This message, so that calls can be chained.
+     */
+    Message & add(boost::string_ref field, boost::string_ref value);
+
+    /**
+     * @return The value of the field, or an empty string if the message has no such field.
+     */
+    std::string get(boost::string_ref field) const;
+
+    /**
+     * @return The value of the field without copying it, valid as long as this message is.
+     */
+    boost::string_ref getView(boost::string_ref field) const;
+
+    bool has(boost::string_ref field) const;
+
+    MessageType getType() const;
+
+    /**
+     * @return True if the message was received in the old text format.
+     */
+    bool isLegacy() const;
+
+    /**
+     * @return The binary representation of the message, ready to be sent.
+     */
+    std::string encode() const;
+
+    /**
+     * @return The message in the old text format, used when a message has to be logged.
+     */
+    std::string toString() const;
+
+    /**
+     * @return The text tag of the type, e.g. "[COUPLE_MESSAGE]".
+     */
+    static const char * getTypeTag(MessageType type);
+
+    /**
+     * Sets the size of field table and payload from which messages of the given type are compressed.
+     * Compressed messages are decoded whatever the threshold of the receiver, so it can be changed
+     * independently by every controller.
+     *
+     * @param threshold Size in bytes, 0 to never compress messages of this type.
+     */
+    static void setCompressionThreshold(MessageType type, size_t threshold);
+
+    static size_t getCompressionThreshold(MessageType type);
+
+    static const char MAGIC[4];
+    static const size_t WIRE_HEADER_SIZE = 16;
+    static const size_t WIRE_FIELD_SIZE = 12;
+    static const uint8_t VERSION = 1;
+    static const uint8_t FLAG_COMPRESSED = 0x01;
+
+    /**
+     * Default threshold of the types that carry genomes, which compress very well.
+     */
+    static const size_t DEFAULT_COMPRESSION_THRESHOLD = 512;
+
+    /**
+     * Largest size of field table and payload a compressed message may inflate to.
+     * Larger sizes announced by a packet are taken as corrupt, rather than allocated.
+     */
+    static const size_t MAXIMUM_INFLATED_SIZE = 64 * 1024 * 1024;
+
+private:
+
+    struct Field
+    {
+        uint32_t offset;
+        uint16_t nameLength;
+        uint32_t valueLength;
+    };
+
+    bool findField(boost::string_ref field, size_t * valueStart, size_t * valueLength) const;
+
+    MessageType type;
+    bool legacy;
+    std::string payload;
+    std::vector<Field> fields;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef shared_MessageDispatcher_h
+#define shared_MessageDispatcher_h
+
+#include "Message.h"
+#include "MessageView.h"
+
+#include <functional>
+#include <string>
+
+
+/**
+ * Table of message handlers indexed by message type, shared by the receive loops of the supervisors.
+ *
+ * Every supervisor registers the handlers of the messages it understands once,
+ * then hands every received packet to dispatch(), which selects the handler in constant time.
+ * For every message type the dispatcher counts the received packets and the time spent handling them.
+ */
+class MessageDispatcher
+{
+public:
+
+    /**
+     * A handler returns false if the packet could not be processed yet and has to be kept in the
+     * receiver queue, true when it is done with the packet.
+     */
+    typedef std::function<bool (const MessageView &)> Handler;
+
+    MessageDispatcher();
+
+    /**
+     * Sets the handler of a message type, replacing the previous one.
+     */
+    void registerHandler(MessageType type, Handler handler);
+
+    void unregisterHandler(MessageType type);
+
+    bool hasHandler(MessageType type) const;
+
+    /**
+     * Calls the handler registered for the type of the message, if any.
+     * The records of a BATCH_MESSAGE are dispatched one by one, in the order they were queued;
+     * since the batch is a single packet it is always consumed, whatever its handlers return.
+     * A BATCH_MESSAGE recorded inside a batch is counted but its records are not dispatched.
+     *
+     * @return The result of the handler, true if there is no handler for the message.
+     */
+    bool dispatch(const MessageView & message);
+
+    /**
+     * @return Number of received messages of the type, handled or not.
+     */
+    unsigned long getCount(MessageType type) const;
+
+    /**
+     * @return Total time, in seconds, spent in the handler of the type.
+     */
+    double getHandlingTime(MessageType type) const;
+
+    /**
+     * @return One line per received message type: tag, count and handling time.
+     */
+    std::string getStatistics() const;
+
+    void resetStatistics();
+
+private:
+
+    Handler handlers[MESSAGE_TYPES_COUNT];
+    unsigned long counts[MESSAGE_TYPES_COUNT];
+    double handlingTimes[MESSAGE_TYPES_COUNT];
+};
+
+#endif
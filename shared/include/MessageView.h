@@ -0,0 +1,95 @@
+#ifndef shared_MessageView_h
+#define shared_MessageView_h
+
+#include "Message.h"
+
+#include <boost/utility/string_ref.hpp>
+#include <memory>
+
+
+/**
+ * Read-only view on a received packet.
+ *
+ * The packet is scanned once on construction and an index of field name -> value is built,
+ * both pointing into the packet itself, so reading a field never copies or allocates.
+ * The view is only valid as long as the packet data is, i.e. until Receiver::nextPacket()
+ * is called; use Message::decode() when the content has to be kept around.
+ *
+ * Compressed packets are the exception: they are inflated once into a buffer owned by the view,
+ * shared by its copies, and the index points into that buffer.
+ *
+ * Packets in the old text format are not indexed: their fields are looked up by
+ * searching the "*FIELD" and "FIELD*" markers, exactly as MessagesManager did.
+ */
+class MessageView
+{
+public:
+
+    /**
+     * Scans the packet. A malformed binary packet results in an UNKNOWN_MESSAGE without fields.
+     *
+     * @param data The packet data, as returned by Receiver::getData().
+     * @param size The packet size, as returned by Receiver::getDataSize().
+     */
+    MessageView(const void * data, size_t size);
+
+    MessageType getType() const;
+
+    bool isLegacy() const;
+
+    /**
+     * @return The value of the field, or an empty view if the message has no such field.
+     */
+    boost::string_ref get(boost::string_ref field) const;
+
+    bool has(boost::string_ref field) const;
+
+    /**
+     * Parses the value of a numeric field, like std::atoi and std::atof would.
+     */
+    long getLong(boost::string_ref field) const;
+
+    double getDouble(boost::string_ref field) const;
+
+    /**
+     * Indexed fields, in the order they were added by the sender.
+     * Always empty for packets in the old text format.
+     */
+    size_t getFieldsCount() const;
+
+    boost::string_ref getFieldName(size_t index) const;
+
+    boost::string_ref getFieldValue(size_t index) const;
+
+    /**
+     * @return The text of a packet in the old format, without the terminating character.
+     */
+    boost::string_ref getText() const;
+
+    /**
+     * @return The message in the old text format, used when a message has to be logged.
+     */
+    std::string toString() const;
+
+private:
+
+    struct Field
+    {
+        boost::string_ref name;
+        boost::string_ref value;
+    };
+
+    bool indexBinary(const char * data, size_t size);
+
+    bool indexFields(const char * table, size_t fieldsCount, size_t payloadSize);
+
+    bool findField(boost::string_ref field, boost::string_ref * value) const;
+
+    MessageType type;
+    bool legacy;
+    boost::string_ref text;
+    std::vector<Field> fields;
+    std::shared_ptr<std::vector<char> > inflated;
+};
+
+#endif
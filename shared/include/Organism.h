@@ -7,6 +7,7 @@
 #include "ParametersReader.h"
 #include "Logger.h"
 
+#include <memory>
 #include <vector>
 #include <boost/smart_ptr/scoped_ptr.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -20,6 +21,10 @@ using boost::property_tree::write_json;
 /**
  * The Organism class is used to store all information about an organism created by the Organism Manager,
  * such as its time-to-live, its genome and which modules it consists of.
+ *
+ * The fields read and updated while the organism lives are plain values, while the genomes and the
+ * parents, which never change, are immutable and shared by all the copies of the organism:
+ * copying an organism copies a few handles, not the genomes.
  */
 class Organism
 {
@@ -27,12 +32,6 @@ public:
     enum State {INFANT, ADULT, DEAD};
     
 protected:
-    
-    double INFANCY_DURATION = ParametersReader::get<double>("INFANCY_DURATION");
-    double ROOMBOT_WAITING_TIME = ParametersReader::get<double>("ROOMBOT_WAITING_TIME");
-    double TIME_TO_LIVE = ParametersReader::get<double>("TIME_TO_LIVE");
-    double TIME_TO_LIVE_NOISE = ParametersReader::get<double>("TIME_TO_LIVE_NOISE");
-    int EVALUATIONS = ParametersReader::get<int>("EVALUATIONS");
 	
     id_t id;                            //Unique id for this instance of organism.
     State state;
@@ -41,12 +40,17 @@ protected:
     double fitness;
     unsigned int size;
     unsigned int offspring;
-    std::vector<id_t> parents;
-    std::string genome;                 //The genome of this organism.
-    std::string mindGenome;             //The genome of this organims' mind.
+    std::shared_ptr<const std::vector<id_t> > parents;
+    std::shared_ptr<const std::string> genome;        //The genome of this organism.
+    std::shared_ptr<const std::string> mindGenome;    //The genome of this organims' mind.
+    mutable std::shared_ptr<const std::string> genomeDigest;  //GenomeStore::digest of the genome, empty until known.
+    mutable std::shared_ptr<const std::string> mindDigest;    //GenomeStore::digest of the mind, empty until known.
     
 public:
 
+    /**
+     * Copies the organism, sharing its genomes and parents with the original.
+     */
     Organism(const Organism& other);
     
     Organism(std::string genome, std::string mindGenome, id_t organismID, double fitness, unsigned int size, unsigned int offspring, std::vector<id_t> parents, State state, bool fertile);
@@ -69,7 +73,7 @@ public:
 	 *
 	 * @return Returns the genome id of this organism.
 	 */
-    std::string getGenome();
+    const std::string & getGenome() const;
     
 	/**
 	 * Sets the genome id for this organism.
@@ -83,46 +87,68 @@ public:
 	 *
 	 * @return Returns the mind of this organism.
 	 */
-    std::string getMind();
+    const std::string & getMind() const;
+    
+    /**
+     * Sets the digests of the genome and of the mind when they are already known, e.g. from
+     * GenomeStore::resolve, so that they are not computed again. setGenome and setMind forget them.
+     */
+    void setDigests(std::string genomeDigest, std::string mindDigest);
+    
+    /**
+     * @return The GenomeStore::digest of the genome, computed on the first call if it was not set.
+     */
+    const std::string & getGenomeDigest() const;
+    
+    /**
+     * @return The GenomeStore::digest of the mind, computed on the first call if it was not set.
+     */
+    const std::string & getMindDigest() const;
     
     void setFitness(double fitness);
     
-    double getFitness();
+    double getFitness() const;
     
     void setState(State state);
     
-    State getState();
+    State getState() const;
     
     void setFertile(bool fertile);
     
-    bool getFertile();
+    bool getFertile() const;
     
     void setSize(unsigned int size);
     
-    unsigned int getSize();
+    unsigned int getSize() const;
     
     void setOffspring(unsigned int offspring);
     
-    unsigned int getOffspring();
+    unsigned int getOffspring() const;
     
     void setParents(std::vector<id_t> parents);
     
-    std::vector<id_t> getParents();
+    const std::vector<id_t> & getParents() const;
     
 	/**
 	 * Returns the id of this organism
 	 *
 	 * @return Returns the id of this organism
 	 */
-	id_t getId();
+	id_t getId() const;
     
-    std::string getName();
+    std::string getName() const;
 };
     
 class BuildableOrganism : public Organism {
 private:
     log4cpp::Category &logger;
     
+    double INFANCY_DURATION = ParametersReader::get<double>("INFANCY_DURATION");
+    double ROOMBOT_WAITING_TIME = ParametersReader::get<double>("ROOMBOT_WAITING_TIME");
+    double TIME_TO_LIVE = ParametersReader::get<double>("TIME_TO_LIVE");
+    double TIME_TO_LIVE_NOISE = ParametersReader::get<double>("TIME_TO_LIVE_NOISE");
+    int EVALUATIONS = ParametersReader::get<int>("EVALUATIONS");
+    
     // Used by the birthclinic
     std::vector<Module*> robots; 		//An array of all robots part of this organism.
 	Position organismCentre;            //The position used as the basis during organism construction.
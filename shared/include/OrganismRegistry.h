@@ -0,0 +1,152 @@
+#ifndef shared_OrganismRegistry_h
+#define shared_OrganismRegistry_h
+
+#include "Organism.h"
+
+#include <functional>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * The organisms known to the evolver, stored contiguously in the order they were added,
+ * together with an index id -> position so that looking an organism up does not depend
+ * on the number of organisms born so far.
+ *
+ * Positions are stable until an organism is removed; removing shifts the following
+ * organisms, exactly as erasing from a vector would, and updates their positions.
+ *
+ * Dead organisms are moved out of the live organisms into an archive that only keeps what the
+ * phylogeny and the statistics need, so scanning the population and the memory held by genomes
+ * grow with the live organisms rather than with all the organisms ever born.
+ *
+ * Statistics of the live organisms are kept up to date on every change, so reporting them does
+ * not scan the population. For this, state, fertility and fitness of the live organisms must be
+ * changed through setState(), setFertile() and setFitness() rather than on the organisms.
+ *
+ * Additions, removals and state changes of the live organisms are reported to the change listener,
+ * so that the list can be rebuilt at any time from the changes instead of being dumped after each of them.
+ */
+class OrganismRegistry
+{
+public:
+
+    /**
+     * What is kept of a dead organism: no genomes, no state.
+     */
+    struct ArchivedOrganism
+    {
+        id_t id;
+        id_t parent1;
+        id_t parent2;
+        unsigned int size;
+        unsigned int offspring;
+        double fitness;
+    };
+
+    /**
+     * Counters of the live organisms; the fitness aggregates are over the adults.
+     */
+    struct Statistics
+    {
+        unsigned int infants = 0;
+        unsigned int adults = 0;
+        unsigned int fertile = 0;
+        unsigned long modules = 0;
+        double fitnessSum = 0;
+        double fitnessSquaresSum = 0;
+
+        double getFitnessMean() const;
+
+        double getFitnessVariance() const;
+    };
+
+    enum Change {ADDED, STATE_CHANGED, REMOVED};
+
+    /**
+     * Called after an organism is added or its state changed, and before it is removed or archived.
+     */
+    typedef std::function<void (Change change, const Organism & organism)> ChangeListener;
+
+    void setChangeListener(const ChangeListener & listener);
+
+    /**
+     * Appends an organism. An organism with the same id must have been removed before.
+     */
+    void add(const Organism & organism);
+
+    /**
+     * Removes the organism at the given position.
+     */
+    void remove(size_t index);
+
+    /**
+     * Moves the organism at the given position to the archive.
+     */
+    void archive(size_t index);
+
+    /**
+     * Moves all the live organisms to the archive.
+     */
+    void archiveAll();
+
+    /**
+     * @return The archived organism, NULL if the organism is not archived.
+     */
+    ArchivedOrganism * findArchived(id_t organismId);
+
+    size_t getArchivedCount() const;
+
+    /**
+     * @return The position of the live organism, -1 if it is not in the registry.
+     */
+    int find(id_t organismId) const;
+
+    /**
+     * @return True if the organism is alive, i.e. not archived.
+     */
+    bool contains(id_t organismId) const;
+
+    void setState(size_t index, Organism::State state);
+
+    void setFertile(size_t index, bool fertile);
+
+    void setFitness(size_t index, double fitness);
+
+    const Statistics & getStatistics() const;
+
+    /**
+     * @return The highest fitness of the adults, 0 if there are none.
+     */
+    double getMaxFitness() const;
+
+    Organism & operator[](size_t index);
+
+    size_t size() const;
+
+    bool empty() const;
+
+    /**
+     * Forgets the live and the archived organisms, reporting the live ones as removed.
+     */
+    void clear();
+
+private:
+
+    /**
+     * Adds (sign 1) or removes (sign -1) the contribution of a live organism to the statistics.
+     * A fitness that is not finite is counted as 0.
+     */
+    void count(const Organism & organism, int sign);
+
+    std::vector<Organism> organisms;
+    std::unordered_map<id_t, size_t> positions;
+    std::vector<ArchivedOrganism> archived;
+    std::unordered_map<id_t, size_t> archivedPositions;
+    Statistics statistics;
+    std::multiset<double> adultsFitness;
+    ChangeListener changeListener;
+};
+
+#endif
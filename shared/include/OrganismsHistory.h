@@ -0,0 +1,78 @@
+#ifndef shared_OrganismsHistory_h
+#define shared_OrganismsHistory_h
+
+#include "OrganismRegistry.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+
+/**
+ * The live organisms of the evolver rebuilt from the changes of its OrganismRegistry,
+ * which the evolver appends to organisms_delta.txt, one per line:
+ *
+ *   time ADD id state
+ *   time STATE id state
+ *   time REMOVE id state
+ *
+ * States are the numeric values of Organism::State. Applying the changes in order gives the live
+ * organisms in the same order as in the registry, so the list at any time of an experiment can be
+ * rebuilt offline without the evolver dumping it after every change.
+ */
+class OrganismsHistory
+{
+public:
+
+    struct Change
+    {
+        double time;
+        OrganismRegistry::Change change;
+        id_t id;
+        int state;
+    };
+
+    struct Entry
+    {
+        id_t id;
+        int state;
+    };
+
+    /**
+     * @return The line of the change, terminated by a newline.
+     */
+    static std::string format(double time, OrganismRegistry::Change change, id_t id, int state);
+
+    /**
+     * Reads the changes of a delta file; comments and malformed lines are skipped.
+     */
+    static std::vector<Change> read(std::istream & stream);
+
+    static const char * HEADER;
+
+    /**
+     * Updates the organisms with a change, which must follow the ones applied before.
+     */
+    void apply(const Change & change);
+
+    /**
+     * Applies the changes up to the given time, included, starting from the first change not applied yet.
+     *
+     * @return The number of changes applied.
+     */
+    size_t applyUntil(const std::vector<Change> & changes, double time);
+
+    const std::vector<Entry> & getOrganisms() const;
+
+    /**
+     * @return The organisms, one per line: position in the list, id and state.
+     */
+    std::string toString() const;
+
+private:
+
+    std::vector<Entry> organisms;
+    size_t applied = 0;
+};
+
+#endif
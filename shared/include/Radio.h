@@ -0,0 +1,52 @@
+#ifndef shared_Radio_h
+#define shared_Radio_h
+
+
+/**
+ * The part of the Webots Emitter interface used to send messages,
+ * so that controllers can be driven either by Webots or by a LocalRadioBus.
+ */
+class RadioEmitter
+{
+public:
+
+    virtual ~RadioEmitter() {}
+
+    virtual int send(const void * data, int size) = 0;
+
+    virtual void setChannel(int channel) = 0;
+
+    virtual int getChannel() const = 0;
+
+    /**
+     * @param range Distance reached by the packets, -1 for no limit.
+     */
+    virtual void setRange(double range) = 0;
+
+    virtual double getRange() const = 0;
+};
+
+
+/**
+ * The part of the Webots Receiver interface used to receive messages.
+ */
+class RadioReceiver
+{
+public:
+
+    virtual ~RadioReceiver() {}
+
+    virtual const void * getData() const = 0;
+
+    virtual int getDataSize() const = 0;
+
+    virtual void nextPacket() = 0;
+
+    virtual int getQueueLength() const = 0;
+
+    virtual void setChannel(int channel) = 0;
+
+    virtual int getChannel() const = 0;
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "JGTL_LocatedException.h"
 
 #include <iostream>
+#include <unordered_map>
 #include <vector>
 #include <exception>
 
@@ -23,6 +24,22 @@ class RoombotBuildPlan : public BuildPlan
 {
 	std::vector<RelativePosition> positions;
 	size_t gridSize;
+	std::unordered_map<long long, int> cells;	//The number of module halves on each occupied cell, by cellKey(x, z)
+	
+	/**
+	 * Returns the key of the cell at x and z in cells.
+	 */
+	static long long cellKey(int x, int z);
+	
+	/**
+	 * Returns the number of module halves on the cell at x and z.
+	 */
+	int modulesOn(int x, int z) const;
+	
+	/**
+	 * Rebuilds cells from positions, after positions have been moved.
+	 */
+	void indexCells();
     
 	/**
 	 * Returns the 'smallest' position of this buildplan.
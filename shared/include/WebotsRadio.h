@@ -0,0 +1,79 @@
+#ifndef shared_WebotsRadio_h
+#define shared_WebotsRadio_h
+
+#include <webots/Robot.hpp>
+#include <webots/Emitter.hpp>
+#include <webots/Receiver.hpp>
+#include "Radio.h"
+using namespace webots;
+
+/**
+ * Webots devices seen through the radio interfaces used by MessageHandler and the supervisors.
+ */
+class WebotsEmitter : public RadioEmitter {
+public:
+    WebotsEmitter(Emitter *em) :
+        emitter(em)
+    {
+    }
+    
+    int send(const void * data, int size) {
+        return emitter->send(data, size);
+    }
+    
+    void setChannel(int channel) {
+        emitter->setChannel(channel);
+    }
+    
+    int getChannel() const {
+        return emitter->getChannel();
+    }
+    
+    void setRange(double range) {
+        emitter->setRange(range);
+    }
+    
+    double getRange() const {
+        return emitter->getRange();
+    }
+    
+private:
+    Emitter *emitter;
+};
+
+class WebotsReceiver : public RadioReceiver {
+public:
+    WebotsReceiver(Receiver *recv) :
+        receiver(recv)
+    {
+    }
+    
+    const void * getData() const {
+        return receiver->getData();
+    }
+    
+    int getDataSize() const {
+        return receiver->getDataSize();
+    }
+    
+    void nextPacket() {
+        receiver->nextPacket();
+    }
+    
+    int getQueueLength() const {
+        return receiver->getQueueLength();
+    }
+    
+    void setChannel(int channel) {
+        receiver->setChannel(channel);
+    }
+    
+    int getChannel() const {
+        return receiver->getChannel();
+    }
+    
+private:
+    Receiver *receiver;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef shared_WorkerPool_h
+#define shared_WorkerPool_h
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Fixed set of threads running batches of independent tasks.
+ *
+ * The thread calling run() works on the batch as well, so a pool without threads
+ * simply runs the tasks one after the other on the caller.
+ */
+class WorkerPool
+{
+public:
+
+    /**
+     * @param threads Number of threads besides the caller of run().
+     */
+    WorkerPool(unsigned int threads);
+
+    ~WorkerPool();
+
+    /**
+     * Runs task(0) to task(count - 1), in any order and on any thread, and waits for all of them.
+     * If tasks throw, the first exception is rethrown once all the tasks have finished.
+     */
+    void run(size_t count, const std::function<void (size_t)> & task);
+
+    size_t getThreadsCount() const;
+
+private:
+
+    void work();
+
+    void runTasks(std::unique_lock<std::mutex> & lock);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable done;
+    const std::function<void (size_t)> * task;
+    size_t count;
+    size_t next;
+    size_t finished;
+    bool stopping;
+    std::exception_ptr error;
+};
+
+#endif
@@ -16,18 +16,36 @@ bool Coordinate::operator<(const Coordinate &other) const
 }
 
 
-ActivationValueMatrix::ActivationValueMatrix(boost::shared_ptr<const NEAT::GeneticIndividual> genome, int width, int height) : width(width), height(height)
+bool ActivationValueMatrix::Candidate::operator<(const Candidate &other) const
+{
+    if(value < other.value) return true;
+    if(value > other.value) return false;
+    return Coordinate(other.x, other.y) < Coordinate(x, y);
+}
+
+
+ActivationValueMatrix::ActivationValueMatrix(boost::shared_ptr<const NEAT::GeneticIndividual> genome, int width, int height, const std::string & evaluator) : ActivationValueMatrix(std::vector<double>(width * height), width, height)
+{
+    //Evaluate every cell once, in the order getMax() scans them
+    bool evaluated = false;
+    if (evaluator == "BATCHED") {
+        evaluated = evaluateBatched(genome);
+    } else if (evaluator == "COMPILED") {
+        evaluated = evaluateCompiled(genome);
+    }
+    if (!evaluated) {
+        evaluate(genome);
+    }
+}
+
+
+ActivationValueMatrix::ActivationValueMatrix(const std::vector<double> & values, int width, int height) : width(width), height(height), values(values)
 {
     //Initialise size
     xModifier = ((double)width-1)/2;
     yModifier = ((double)height-1)/2;
     
-    //Initialise the phenotype
-    cppn = genome->spawnFastPhenotypeStack<double> ();
-    cppn.setValue(INPUT_BIAS, 1);
-    cppn.setValue(INPUT_X, 0);
-    cppn.setValue(INPUT_Y, 0);
-    cppn.setActivated(true);
+    adjacent.assign(width * height, false);
     
     //Initialise the 'used' matrix
     unsigned int i, j;
@@ -103,15 +121,17 @@ Coordinate ActivationValueMatrix::getMaxAdjacent() const
     Coordinate result;
     result.found = false;
     result.value = THRESHOLD;
-    set<Coordinate>::iterator it;
-    
-    for (it=adjacentCoordinates.begin(); it!=adjacentCoordinates.end(); it++){
-        if (get(*it) > result.value && !getUsed(*it)) {
-            result.value = get(*it);
-            result.x = (*it).x;
-            result.y = (*it).y;
-            result.found = true;
-        }
+    
+    //Drop the cells that stopped being adjacent since they were added
+    while (!candidates.empty() && !adjacent[candidates.top().x * height + candidates.top().y]) {
+        candidates.pop();
+    }
+    
+    if (!candidates.empty()) {
+        result.value = get(candidates.top().x, candidates.top().y);
+        result.x = candidates.top().x;
+        result.y = candidates.top().y;
+        result.found = true;
     }
     
     return result;
@@ -122,7 +142,7 @@ Coordinate ActivationValueMatrix::getMaxAdjacent() const
 void ActivationValueMatrix::setUsed(const Coordinate& coordinate, bool newUsed)
 {
     used->insert_element(coordinate.x, coordinate.y, newUsed);
-    adjacentCoordinates.erase(coordinate);
+    adjacent[coordinate.x * height + coordinate.y] = false;
 }
 
 
@@ -137,14 +157,107 @@ void ActivationValueMatrix::addModuleCoordinate(const Coordinate& coordinate)
         x = coordinate.x + xMod[i];
         y = coordinate.y + yMod[i];
         if (inBounds(x, y)){
-            if (!getUsed(x, y)) {
-                adjacentCoordinates.insert(Coordinate(x, y));
+            if (!getUsed(x, y) && !adjacent[x * height + y]) {
+                adjacent[x * height + y] = true;
+                //Cells not above THRESHOLD are never the best adjacent cell
+                if (get(x, y) > THRESHOLD) {
+                    Candidate candidate;
+                    candidate.value = get(x, y);
+                    candidate.x = x;
+                    candidate.y = y;
+                    candidates.push(candidate);
+                }
             }
         }
     }
 }
 
 
+void ActivationValueMatrix::evaluate(boost::shared_ptr<const NEAT::GeneticIndividual> genome)
+{
+    //Initialise the phenotype
+    NEAT::FastNetwork<double> cppn = genome->spawnFastPhenotypeStack<double> ();
+    cppn.setValue(INPUT_BIAS, 1);
+    cppn.setValue(INPUT_X, 0);
+    cppn.setValue(INPUT_Y, 0);
+    cppn.setActivated(true);
+    
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            cppn.setValue(INPUT_X, x - xModifier);
+            cppn.setValue(INPUT_Y, y - yModifier);
+            cppn.update();
+            values[x * height + y] = cppn.getValue(OUTPUT);
+        }
+    }
+}
+
+
+bool ActivationValueMatrix::evaluateCompiled(boost::shared_ptr<const NEAT::GeneticIndividual> genome)
+{
+    CompiledNetwork cppn(genome);
+    if (!cppn.isCompiled()) {
+        return false;
+    }
+    
+    int xInput = cppn.getSlot(INPUT_X);
+    int yInput = cppn.getSlot(INPUT_Y);
+    int output = cppn.getSlot(OUTPUT);
+    cppn.setValue(cppn.getSlot(INPUT_BIAS), 1);
+    cppn.setActivated(true);
+    
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            cppn.setValue(xInput, x - xModifier);
+            cppn.setValue(yInput, y - yModifier);
+            cppn.update();
+            values[x * height + y] = cppn.getValue(output);
+        }
+    }
+    return true;
+}
+
+
+bool ActivationValueMatrix::evaluateBatched(boost::shared_ptr<const NEAT::GeneticIndividual> genome)
+{
+    BatchedNetwork cppn(genome);
+    if (!cppn.isBatchable()) {
+        return false;
+    }
+    
+    std::vector<double> xInputs(width * height);
+    std::vector<double> yInputs(width * height);
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            xInputs[x * height + y] = x - xModifier;
+            yInputs[x * height + y] = y - yModifier;
+        }
+    }
+    cppn.setValue(INPUT_BIAS, 1);
+    cppn.setValues(INPUT_X, xInputs);
+    cppn.setValues(INPUT_Y, yInputs);
+    cppn.setActivated(true);
+    cppn.update(width * height);
+    
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = cppn.getValue(OUTPUT, i);
+    }
+    return true;
+}
+
+
+int ActivationValueMatrix::getWidth() const
+{
+    return width;
+}
+
+
+int ActivationValueMatrix::getHeight() const
+{
+    return height;
+}
+
+
 bool ActivationValueMatrix::getUsed(int x, int y) const
 {
     return used->at_element(x, y);
@@ -159,10 +272,7 @@ bool ActivationValueMatrix::getUsed(const Coordinate& coordinate) const
 
 double ActivationValueMatrix::get(int x, int y) const
 {
-    cppn.setValue(INPUT_X, x - xModifier);
-    cppn.setValue(INPUT_Y, y - yModifier);
-    cppn.update();
-    return cppn.getValue(OUTPUT);
+    return values[x * height + y];
 }
 
 
@@ -0,0 +1,128 @@
+#include "AngleFrame.h"
+
+#include <cstring>
+
+
+static const char MAGIC[2] = { 'A', 'F' };
+
+
+static char * writeHeader(std::vector<char> & buffer, AngleFrame::Type type, double timestamp, size_t moduleIndex, size_t modulesCount, size_t anglesCount)
+{
+    size_t size = AngleFrame::getSize(modulesCount, anglesCount);
+    if (buffer.size() < size)
+    {
+        buffer.resize(size);
+    }
+
+    char * out = &buffer[0];
+    uint16_t header[4] = { (uint16_t) moduleIndex, (uint16_t) modulesCount, (uint16_t) anglesCount, 0 };
+    std::memcpy(out, MAGIC, 2);
+    out[2] = (char) type;
+    out[3] = 0;
+    std::memcpy(out + 4, header, sizeof(header));
+    std::memcpy(out + 12, &timestamp, sizeof(double));
+    return out + AngleFrame::HEADER_SIZE_BYTES;
+}
+
+
+size_t AngleFrame::getSize(size_t modulesCount, size_t anglesCount)
+{
+    return HEADER_SIZE_BYTES + modulesCount * anglesCount * sizeof(double);
+}
+
+
+size_t AngleFrame::encodeCommand(std::vector<char> & buffer, double timestamp, const std::vector<std::vector<double> > & angles)
+{
+    size_t anglesCount = angles.empty() ? 0 : angles[0].size();
+    char * out = writeHeader(buffer, COMMAND, timestamp, 0, angles.size(), anglesCount);
+    for (size_t i = 0; i < angles.size(); i++)
+    {
+        std::memcpy(out + i * anglesCount * sizeof(double), angles[i].data(), anglesCount * sizeof(double));
+    }
+    return getSize(angles.size(), anglesCount);
+}
+
+
+size_t AngleFrame::encodeInform(std::vector<char> & buffer, double timestamp, size_t moduleIndex, const std::vector<double> & angles)
+{
+    char * out = writeHeader(buffer, INFORM, timestamp, moduleIndex, 1, angles.size());
+    std::memcpy(out, angles.data(), angles.size() * sizeof(double));
+    return getSize(1, angles.size());
+}
+
+
+AngleFrame::AngleFrame(const void * data, size_t size) :
+    data((const char *) data),
+    valid(false),
+    type(COMMAND),
+    timestamp(0),
+    moduleIndex(0),
+    modulesCount(0),
+    anglesCount(0)
+{
+    if (data == NULL || size < HEADER_SIZE_BYTES || std::memcmp(data, MAGIC, 2) != 0)
+    {
+        return;
+    }
+
+    uint16_t header[4];
+    std::memcpy(header, this->data + 4, sizeof(header));
+    std::memcpy(&timestamp, this->data + 12, sizeof(double));
+    type = (Type) this->data[2];
+    moduleIndex = header[0];
+    modulesCount = header[1];
+    anglesCount = header[2];
+
+    valid = (type == COMMAND || type == INFORM) && size == getSize(modulesCount, anglesCount);
+}
+
+
+bool AngleFrame::isValid() const
+{
+    return valid;
+}
+
+
+AngleFrame::Type AngleFrame::getType() const
+{
+    return type;
+}
+
+
+double AngleFrame::getTimestamp() const
+{
+    return timestamp;
+}
+
+
+size_t AngleFrame::getModuleIndex() const
+{
+    return moduleIndex;
+}
+
+
+size_t AngleFrame::getModulesCount() const
+{
+    return modulesCount;
+}
+
+
+size_t AngleFrame::getAnglesCount() const
+{
+    return anglesCount;
+}
+
+
+double AngleFrame::getAngle(size_t module, size_t angle) const
+{
+    double value;
+    std::memcpy(&value, data + HEADER_SIZE_BYTES + (module * anglesCount + angle) * sizeof(double), sizeof(double));
+    return value;
+}
+
+
+void AngleFrame::copyAngles(size_t module, std::vector<double> & angles) const
+{
+    size_t count = angles.size() < anglesCount ? angles.size() : anglesCount;
+    std::memcpy(angles.data(), data + HEADER_SIZE_BYTES + module * anglesCount * sizeof(double), count * sizeof(double));
+}
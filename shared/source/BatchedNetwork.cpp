@@ -0,0 +1,182 @@
+#include "BatchedNetwork.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+const double BatchedNetwork::TOLERANCE = 1e-9;
+
+
+/**
+ * sum[i] += weight * source[i] for i in 0 .. count - 1.
+ */
+static void accumulate(double * sum, const double * source, double weight, size_t count)
+{
+    size_t i = 0;
+#if defined(__AVX__)
+    __m256d weights = _mm256_set1_pd(weight);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm256_storeu_pd(sum + i, _mm256_add_pd(_mm256_loadu_pd(sum + i), _mm256_mul_pd(_mm256_loadu_pd(source + i), weights)));
+    }
+#elif defined(__SSE2__)
+    __m128d weights = _mm_set1_pd(weight);
+    for (; i + 2 <= count; i += 2)
+    {
+        _mm_storeu_pd(sum + i, _mm_add_pd(_mm_loadu_pd(sum + i), _mm_mul_pd(_mm_loadu_pd(source + i), weights)));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        sum[i] += source[i] * weight;
+    }
+}
+
+
+BatchedNetwork::BatchedNetwork(boost::shared_ptr<const NEAT::GeneticIndividual> genome) : BatchedNetwork(CompiledNetwork(genome))
+{
+    //nix
+}
+
+
+BatchedNetwork::BatchedNetwork(const CompiledNetwork & compiled) : network(compiled), stride(0), samplesCount(0), activated(false)
+{
+    inputValues.assign(network.getSlotsCount(), std::vector<double>(1, 0));
+    reserve(1);
+}
+
+
+bool BatchedNetwork::isBatchable() const
+{
+    return network.isCompiled();
+}
+
+
+bool BatchedNetwork::hasNode(const std::string & node) const
+{
+    return network.getSlot(node) >= 0;
+}
+
+
+void BatchedNetwork::setValue(const std::string & node, double value)
+{
+    int slot = getSlot(node);
+    if (network.isInput(slot)) {
+        inputValues[slot].assign(1, value);
+    } else {
+        values[slot * stride] = value;
+    }
+}
+
+
+void BatchedNetwork::setValues(const std::string & node, const std::vector<double> & newValues)
+{
+    int slot = getSlot(node);
+    if (network.isInput(slot) && !newValues.empty()) {
+        inputValues[slot] = newValues;
+    }
+}
+
+
+void BatchedNetwork::update(size_t samples)
+{
+    reserve(samples);
+    samplesCount = samples;
+
+    for (size_t i = 0; i < inputValues.size(); i++) {
+        if (network.isInput(i)) {
+            const std::vector<double> & given = inputValues[i];
+            double * slots = &values[i * stride + 1];
+            size_t count = std::min(given.size(), samples);
+            std::copy(given.begin(), given.begin() + count, slots);
+            std::fill(slots + count, slots + samples, given[count - 1]);
+        }
+    }
+
+    if (!activated) {
+        activated = true;
+        for (int i = 0; i < network.getActivationUpdates(); i++) {
+            iterate(1);
+        }
+    }
+    iterate(samples);
+}
+
+
+double BatchedNetwork::getValue(const std::string & node, size_t sample) const
+{
+    return values[getSlot(node) * stride + 1 + sample];
+}
+
+
+void BatchedNetwork::reinitialize()
+{
+    std::fill(values.begin(), values.end(), 0);
+    activated = false;
+}
+
+
+void BatchedNetwork::setActivated(bool value)
+{
+    activated = value;
+}
+
+
+size_t BatchedNetwork::getSamplesCount() const
+{
+    return samplesCount;
+}
+
+
+void BatchedNetwork::iterate(size_t count)
+{
+    const std::vector<CompiledNetwork::Instruction> & instructions = network.getInstructions();
+    const std::vector<CompiledNetwork::Link> & links = network.getLinks();
+
+    //An updated node reads the previous sample of the updated nodes, i.e. slot k for sample k,
+    //and the current sample of the input nodes, i.e. slot k + 1
+    for (size_t i = 0; i < instructions.size(); i++) {
+        const CompiledNetwork::Instruction & instruction = instructions[i];
+        double * sums = &values[instruction.target * stride + 1];
+        std::fill(sums, sums + count, 0);
+        for (size_t j = instruction.firstLink; j < instruction.firstLink + instruction.linksCount; j++) {
+            accumulate(sums, &values[links[j].source * stride + (network.isInput(links[j].source) ? 1 : 0)], links[j].weight, count);
+        }
+        for (size_t k = 0; k < count; k++) {
+            sums[k] = instruction.activation(sums[k]);
+        }
+    }
+
+    //Only now, since the nodes after a node in the order read its state
+    for (size_t i = 0; i < instructions.size(); i++) {
+        values[instructions[i].target * stride] = values[instructions[i].target * stride + count];
+    }
+}
+
+
+void BatchedNetwork::reserve(size_t samples)
+{
+    if (samples + 1 <= stride) {
+        return;
+    }
+    std::vector<double> resized(network.getSlotsCount() * (samples + 1), 0);
+    for (size_t i = 0; i < network.getSlotsCount() && stride > 0; i++) {
+        resized[i * (samples + 1)] = values[i * stride];
+    }
+    values.swap(resized);
+    stride = samples + 1;
+}
+
+
+int BatchedNetwork::getSlot(const std::string & node) const
+{
+    int slot = network.getSlot(node);
+    if (slot < 0) {
+        throw std::out_of_range("BatchedNetwork has no node " + node);
+    }
+    return slot;
+}
@@ -1,5 +1,7 @@
 #include "Builder.h"
 
+#include <limits>
+
 
 Builder::Builder()
 {
@@ -23,8 +25,26 @@ CppnGenome Builder::getGenomeFromStream(std::istream& stream)
 std::auto_ptr<BuildPlan> Builder::translateGenome(CppnGenome genome) const
 {
     size_t gridSize = (size_t)(genome.getSize() + 0.5);
-    ActivationValueMatrix matrix = ActivationValueMatrix(genome.getCppn(), gridSize, gridSize);
-    RoombotBuildPlan* buildPlan = new RoombotBuildPlan(gridSize);
+    ActivationValueMatrix matrix(genome.getCppn(), gridSize, gridSize, CPPN_EVALUATOR);
+    return translate(matrix, std::numeric_limits<size_t>::max());
+}
+
+
+bool Builder::hasModules(CppnGenome genome, size_t modules) const
+{
+    if (modules == 0)
+    {
+        return true;
+    }
+    size_t gridSize = (size_t)(genome.getSize() + 0.5);
+    ActivationValueMatrix matrix(genome.getCppn(), gridSize, gridSize, CPPN_EVALUATOR);
+    return translate(matrix, modules)->size() >= modules;
+}
+
+
+std::auto_ptr<BuildPlan> Builder::translate(ActivationValueMatrix & matrix, size_t maximumModules)
+{
+    RoombotBuildPlan* buildPlan = new RoombotBuildPlan(matrix.getWidth());
     
     Coordinate max;
     Coordinate maxNeighbour;
@@ -52,7 +72,7 @@ std::auto_ptr<BuildPlan> Builder::translateGenome(CppnGenome genome) const
     matrix.addModuleCoordinate(maxNeighbour);
     
     //Find the rest of the modules
-    while (max.found) {
+    while (max.found && buildPlan->size() < maximumModules) {
         //Get the max value adjacent to the current organism
         max = matrix.getMaxAdjacent();
         matrix.setUsed(max, true);
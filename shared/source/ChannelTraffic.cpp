@@ -0,0 +1,67 @@
+#include "ChannelTraffic.h"
+
+#include <algorithm>
+#include <fstream>
+
+
+void ChannelTraffic::countSent(int channel, size_t bytes)
+{
+    Counters & counters = channels[channel];
+    counters.sentPackets++;
+    counters.sentBytes += bytes;
+    counters.largestPacket = std::max(counters.largestPacket, bytes);
+}
+
+
+void ChannelTraffic::countReceived(int channel, size_t bytes)
+{
+    Counters & counters = channels[channel];
+    counters.receivedPackets++;
+    counters.receivedBytes += bytes;
+    counters.largestPacket = std::max(counters.largestPacket, bytes);
+}
+
+
+void ChannelTraffic::countQueueLength(int channel, int length)
+{
+    Counters & counters = channels[channel];
+    counters.maxQueueLength = std::max(counters.maxQueueLength, length);
+    counters.queueLengthSum += length;
+    counters.queueSamples++;
+}
+
+
+void ChannelTraffic::store(const std::string & path, const std::string & source, double time)
+{
+    bool exists = std::ifstream(path).good();
+
+    std::ofstream file;
+    file.open(path, std::ios::app);
+    if (!exists)
+    {
+        file << "#time source channel sent_packets sent_bytes received_packets received_bytes largest_packet max_queue mean_queue" << std::endl;
+    }
+
+    // one write per store, the file is shared by all the controllers
+    std::string lines;
+    for (std::map<int, Counters>::const_iterator it = channels.begin(); it != channels.end(); ++it)
+    {
+        const Counters & counters = it->second;
+        double meanQueue = counters.queueSamples > 0 ? (double) counters.queueLengthSum / counters.queueSamples : 0;
+        lines += std::to_string(time) + " " + source + " " + std::to_string(it->first) + " " +
+            std::to_string(counters.sentPackets) + " " + std::to_string(counters.sentBytes) + " " +
+            std::to_string(counters.receivedPackets) + " " + std::to_string(counters.receivedBytes) + " " +
+            std::to_string(counters.largestPacket) + " " + std::to_string(counters.maxQueueLength) + " " +
+            std::to_string(meanQueue) + "\n";
+    }
+    file << lines;
+    file.close();
+
+    reset();
+}
+
+
+void ChannelTraffic::reset()
+{
+    channels.clear();
+}
@@ -0,0 +1,312 @@
+#include "CompiledNetwork.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+/********************************************/
+/********** ACTIVATION FUNCTIONS ************/
+/********************************************/
+
+static double sigmoid(double value)
+{
+    return 1 / (1 + std::exp(-value));
+}
+
+
+static double signedSigmoid(double value)
+{
+    return ((1 / (1 + std::exp(-value))) - 0.5) * 2.0;
+}
+
+
+static double tanhSigmoid(double value)
+{
+    return std::tanh(value);
+}
+
+
+static double sine(double value)
+{
+    return std::sin(value);
+}
+
+
+static double cosine(double value)
+{
+    return std::cos(value);
+}
+
+
+static double gaussian(double value)
+{
+    return std::exp(-value * value);
+}
+
+
+static double signedGaussian(double value)
+{
+    return (std::exp(-value * value) - 0.5) * 2.0;
+}
+
+
+static double square(double value)
+{
+    return value * value;
+}
+
+
+static double absoluteRoot(double value)
+{
+    return std::sqrt(std::fabs(value));
+}
+
+
+static double linear(double value)
+{
+    return value;
+}
+
+
+/**
+ * @return The activation function FastNetwork runs for the function of a node,
+ * or NULL for the functions that are not compiled.
+ */
+static CompiledNetwork::Activation resolve(ActivationFunction function, bool signedActivation, bool usingTanhSigmoid)
+{
+    switch (function)
+    {
+        case ACTIVATION_FUNCTION_SIGMOID:
+            if (signedActivation) {
+                return usingTanhSigmoid ? tanhSigmoid : signedSigmoid;
+            }
+            return sigmoid;
+        case ACTIVATION_FUNCTION_SIN:
+            return sine;
+        case ACTIVATION_FUNCTION_COS:
+            return cosine;
+        case ACTIVATION_FUNCTION_GAUSSIAN:
+            return signedActivation ? signedGaussian : gaussian;
+        case ACTIVATION_FUNCTION_SQUARE:
+            return square;
+        case ACTIVATION_FUNCTION_ABS_ROOT:
+            return absoluteRoot;
+        case ACTIVATION_FUNCTION_LINEAR:
+            return linear;
+        default:
+            return NULL;
+    }
+}
+
+
+/********************************************/
+/************ COMPILED NETWORK **************/
+/********************************************/
+
+/**
+ * @return The node genes of the genome, in its order.
+ */
+static std::vector<CompiledNetwork::Node> readNodes(const NEAT::GeneticIndividual & genome)
+{
+    std::vector<CompiledNetwork::Node> nodes(genome.getNodesCount());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const NEAT::GeneticNodeGene * gene = genome.getNode(i);
+        nodes[i].id = gene->getID();
+        nodes[i].name = gene->getName();
+        nodes[i].input = gene->getType() == "NetworkSensor";
+        nodes[i].function = gene->getActivationFunction();
+    }
+    return nodes;
+}
+
+
+/**
+ * @return The link genes of the genome, in its order.
+ */
+static std::vector<CompiledNetwork::Connection> readConnections(const NEAT::GeneticIndividual & genome)
+{
+    std::vector<CompiledNetwork::Connection> connections(genome.getLinksCount());
+    for (size_t i = 0; i < connections.size(); i++) {
+        const NEAT::GeneticLinkGene * gene = genome.getLink(i);
+        connections[i].from = gene->getFromNodeID();
+        connections[i].to = gene->getToNodeID();
+        connections[i].weight = gene->getWeight();
+    }
+    return connections;
+}
+
+
+CompiledNetwork::CompiledNetwork(boost::shared_ptr<const NEAT::GeneticIndividual> genome) :
+    CompiledNetwork(readNodes(*genome), readConnections(*genome), NEAT::Globals::getSingleton()->getExtraActivationUpdates(),
+                    NEAT::Globals::getSingleton()->hasSignedActivation(), NEAT::Globals::getSingleton()->isUsingTanhSigmoid())
+{
+    //nix
+}
+
+
+CompiledNetwork::CompiledNetwork(const std::vector<Node> & nodes, const std::vector<Connection> & connections, int extraActivationUpdates, bool signedActivation, bool usingTanhSigmoid) : compiled(true), activated(false)
+{
+    activationUpdates = 1 + extraActivationUpdates;
+
+    size_t count = nodes.size();
+    std::map<int, int> geneSlots;
+    std::vector<Activation> activations(count);
+    values.assign(count, 0);
+    inputs.assign(count, false);
+    for (size_t i = 0; i < count; i++) {
+        inputs[i] = nodes[i].input;
+        activations[i] = resolve(nodes[i].function, signedActivation, usingTanhSigmoid);
+        slots[nodes[i].name] = i;
+        geneSlots[nodes[i].id] = i;
+        if (!inputs[i] && activations[i] == NULL) {
+            compiled = false;
+        }
+    }
+
+    //The links of every updated node, in the order of the genome, which is the order FastNetwork sums them in.
+    //Links into input nodes are left out, since FastNetwork keeps input nodes constant
+    std::vector<std::vector<Link> > nodeLinks(count);
+    std::vector<size_t> pending(count, 0);
+    std::vector<std::vector<int> > readers(count);
+    for (size_t i = 0; i < connections.size(); i++) {
+        Link link;
+        link.source = geneSlots[connections[i].from];
+        link.weight = connections[i].weight;
+        int target = geneSlots[connections[i].to];
+        if (!inputs[target]) {
+            nodeLinks[target].push_back(link);
+            if (!inputs[link.source]) {
+                pending[target]++;
+                readers[link.source].push_back(target);
+            }
+        }
+    }
+
+    //Order the updated nodes so that each comes after the nodes it reads
+    std::vector<int> order;
+    size_t updated = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!inputs[i]) {
+            updated++;
+            if (pending[i] == 0) {
+                order.push_back(i);
+            }
+        }
+    }
+    for (size_t i = 0; i < order.size(); i++) {
+        for (size_t j = 0; j < readers[order[i]].size(); j++) {
+            if (--pending[readers[order[i]][j]] == 0) {
+                order.push_back(readers[order[i]][j]);
+            }
+        }
+    }
+    if (order.size() < updated) {
+        compiled = false;
+        return;
+    }
+
+    for (size_t i = 0; i < order.size(); i++) {
+        Instruction instruction;
+        instruction.target = order[i];
+        instruction.activation = activations[order[i]];
+        instruction.firstLink = links.size();
+        instruction.linksCount = nodeLinks[order[i]].size();
+        instructions.push_back(instruction);
+        links.insert(links.end(), nodeLinks[order[i]].begin(), nodeLinks[order[i]].end());
+    }
+}
+
+
+bool CompiledNetwork::isCompiled() const
+{
+    return compiled;
+}
+
+
+int CompiledNetwork::getSlot(const std::string & node) const
+{
+    std::map<std::string, int>::const_iterator slot = slots.find(node);
+    return slot == slots.end() ? -1 : slot->second;
+}
+
+
+size_t CompiledNetwork::getSlotsCount() const
+{
+    return values.size();
+}
+
+
+bool CompiledNetwork::isInput(int slot) const
+{
+    return inputs[slot];
+}
+
+
+void CompiledNetwork::setValue(int slot, double value)
+{
+    values[slot] = value;
+}
+
+
+double CompiledNetwork::getValue(int slot) const
+{
+    return values[slot];
+}
+
+
+void CompiledNetwork::update()
+{
+    if (!activated) {
+        activated = true;
+        for (int i = 0; i < activationUpdates; i++) {
+            iterate();
+        }
+    }
+    iterate();
+}
+
+
+void CompiledNetwork::reinitialize()
+{
+    std::fill(values.begin(), values.end(), 0);
+    activated = false;
+}
+
+
+void CompiledNetwork::setActivated(bool value)
+{
+    activated = value;
+}
+
+
+int CompiledNetwork::getActivationUpdates() const
+{
+    return activationUpdates;
+}
+
+
+const std::vector<CompiledNetwork::Instruction> & CompiledNetwork::getInstructions() const
+{
+    return instructions;
+}
+
+
+const std::vector<CompiledNetwork::Link> & CompiledNetwork::getLinks() const
+{
+    return links;
+}
+
+
+void CompiledNetwork::iterate()
+{
+    //Backwards, so that the nodes an instruction reads still hold the values of the previous update
+    for (size_t i = instructions.size(); i-- > 0;) {
+        const Instruction & instruction = instructions[i];
+        const Link * link = links.data() + instruction.firstLink;
+        double sum = 0;
+        for (size_t j = 0; j < instruction.linksCount; j++) {
+            sum += values[link[j].source] * link[j].weight;
+        }
+        values[instruction.target] = instruction.activation(sum);
+    }
+}
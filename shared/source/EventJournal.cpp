@@ -0,0 +1,121 @@
+#include "EventJournal.h"
+
+#include <chrono>
+
+
+EventJournal::EventJournal(size_t maximumBufferedSize, double flushInterval) :
+maximumBufferedSize(maximumBufferedSize),
+flushInterval(flushInterval),
+bufferedSize(0),
+flushing(false),
+stopping(false)
+{
+    writer = std::thread(&EventJournal::work, this);
+}
+
+
+EventJournal::~EventJournal()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    writer.join();
+}
+
+
+void EventJournal::write(const std::string & path, const std::string & text, const std::string & header)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (bufferedSize > maximumBufferedSize)
+    {
+        wakeUp.notify_all();
+        written.wait(lock, [this] { return bufferedSize <= maximumBufferedSize; });
+    }
+
+    std::unique_ptr<File> & file = files[path];
+    if (!file)
+    {
+        file.reset(new File());
+        file->path = path;
+        order.push_back(file.get());
+        if (!header.empty() && !std::ifstream(path).good())
+        {
+            file->buffer = header;
+            bufferedSize += header.size();
+        }
+    }
+    file->buffer += text;
+    bufferedSize += text.size();
+}
+
+
+void EventJournal::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (bufferedSize == 0)
+    {
+        return;
+    }
+    flushing = true;
+    wakeUp.notify_all();
+    written.wait(lock, [this] { return bufferedSize == 0; });
+}
+
+
+size_t EventJournal::getBufferedSize()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bufferedSize;
+}
+
+
+void EventJournal::work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wakeUp.wait_for(lock, std::chrono::duration<double>(flushInterval), [this] {
+            return stopping || flushing || bufferedSize > maximumBufferedSize;
+        });
+
+        // take the buffers, so that events can be written while they are appended to the files
+        std::vector<std::pair<File *, std::string> > batch;
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            if (!order[i]->buffer.empty())
+            {
+                batch.push_back(std::make_pair(order[i], std::string()));
+                batch.back().second.swap(order[i]->buffer);
+            }
+        }
+        bool stop = stopping;
+        lock.unlock();
+
+        size_t size = 0;
+        for (size_t i = 0; i < batch.size(); i++)
+        {
+            File * file = batch[i].first;
+            if (!file->stream.is_open())
+            {
+                file->stream.open(file->path, std::ios::app);
+            }
+            file->stream << batch[i].second;
+            file->stream.flush();
+            size += batch[i].second.size();
+        }
+
+        lock.lock();
+        bufferedSize -= size;
+        if (bufferedSize == 0)
+        {
+            flushing = false;
+        }
+        written.notify_all();
+        if (stop && bufferedSize == 0)
+        {
+            return;
+        }
+    }
+}
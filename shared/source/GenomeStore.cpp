@@ -0,0 +1,334 @@
+#include "GenomeStore.h"
+
+#include <cstring>
+
+
+/********************************************/
+/***************** SHA-256 ******************/
+/********************************************/
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+static inline uint32_t rotateRight(uint32_t value, int bits)
+{
+    return (value >> bits) | (value << (32 - bits));
+}
+
+
+static void sha256Block(uint32_t state[8], const unsigned char * block)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) | ((uint32_t)block[4 * i + 2] << 8) | (uint32_t)block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+        uint32_t choice = (e & f) ^ (~e & g);
+        uint32_t temp1 = h + s1 + choice + SHA256_K[i] + w[i];
+        uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+        uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t temp2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+
+/********************************************/
+/*************** GENOME STORE ***************/
+/********************************************/
+
+GenomeStore::GenomeStore(size_t capacity) : capacity(capacity)
+{
+    //nix
+}
+
+
+std::string GenomeStore::digest(boost::string_ref content)
+{
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    const unsigned char * data = (const unsigned char *) content.data();
+    size_t size = content.size();
+    size_t position = 0;
+    for (; position + 64 <= size; position += 64)
+    {
+        sha256Block(state, data + position);
+    }
+
+    // last block(s): remaining bytes, a 1 bit, zeros, and the length in bits
+    unsigned char tail[128];
+    size_t remaining = size - position;
+    std::memset(tail, 0, sizeof(tail));
+    std::memcpy(tail, data + position, remaining);
+    tail[remaining] = 0x80;
+    size_t tailSize = remaining + 9 <= 64 ? 64 : 128;
+    uint64_t bits = (uint64_t)size * 8;
+    for (int i = 0; i < 8; i++)
+    {
+        tail[tailSize - 1 - i] = (unsigned char)((bits >> (8 * i)) & 0xff);
+    }
+    sha256Block(state, tail);
+    if (tailSize == 128)
+    {
+        sha256Block(state, tail + 64);
+    }
+
+    static const char HEX[] = "0123456789abcdef";
+    std::string result(64, '0');
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            result[i * 8 + j] = HEX[(state[i] >> (28 - 4 * j)) & 0xf];
+        }
+    }
+    return result;
+}
+
+
+std::string GenomeStore::put(boost::string_ref content)
+{
+    std::string key = digest(content);
+    store(key, content);
+    return key;
+}
+
+
+bool GenomeStore::put(boost::string_ref digest, boost::string_ref content)
+{
+    std::string key = digest.to_string();
+    std::unordered_map<std::string, Entry>::iterator stored = genomes.find(key);
+    if (stored != genomes.end())
+    {
+        if (content != boost::string_ref(stored->second.content))
+        {
+            return false;
+        }
+        touch(stored->second);
+        return true;
+    }
+    if (GenomeStore::digest(content) != key)
+    {
+        return false;
+    }
+    store(key, content);
+    return true;
+}
+
+
+const std::string * GenomeStore::find(boost::string_ref digest) const
+{
+    std::unordered_map<std::string, Entry>::const_iterator it = genomes.find(digest.to_string());
+    if (it == genomes.end())
+    {
+        return NULL;
+    }
+    return &it->second.content;
+}
+
+
+bool GenomeStore::contains(boost::string_ref digest) const
+{
+    return find(digest) != NULL;
+}
+
+
+bool GenomeStore::hold(boost::string_ref digest)
+{
+    std::unordered_map<std::string, Entry>::iterator it = genomes.find(digest.to_string());
+    if (it == genomes.end())
+    {
+        return false;
+    }
+    if (it->second.holders++ == 0)
+    {
+        unheld.erase(it->second.unheldPosition);
+    }
+    return true;
+}
+
+
+void GenomeStore::release(boost::string_ref digest)
+{
+    std::unordered_map<std::string, Entry>::iterator it = genomes.find(digest.to_string());
+    if (it == genomes.end() || it->second.holders == 0)
+    {
+        return;
+    }
+    if (--it->second.holders == 0)
+    {
+        unheld.push_front(it->first);
+        it->second.unheldPosition = unheld.begin();
+        shrink();
+    }
+}
+
+
+size_t GenomeStore::size() const
+{
+    return genomes.size();
+}
+
+
+void GenomeStore::addFull(Message & message, const std::string & field, const std::string & content)
+{
+    message.add(field + "_DIGEST", put(content));
+    message.add(field, content);
+}
+
+
+void GenomeStore::addDigest(Message & message, const std::string & field, const std::string & content)
+{
+    message.add(field + "_DIGEST", put(content));
+}
+
+
+void GenomeStore::add(Message & message, const std::string & field, const std::string & content, int channel)
+{
+    std::string key = put(content);
+    message.add(field + "_DIGEST", key);
+    if (sent[channel].insert(key).second)
+    {
+        message.add(field, content);
+    }
+}
+
+
+void GenomeStore::forgetSent(int channel)
+{
+    sent.erase(channel);
+}
+
+
+bool GenomeStore::resolve(const MessageView & message, const std::string & field, std::string * content, std::string * contentDigest)
+{
+    boost::string_ref key = message.get(field + "_DIGEST");
+    if (message.has(field))
+    {
+        boost::string_ref value = message.get(field);
+        std::string stored;
+        if (!key.empty() && put(key, value))
+        {
+            stored = key.to_string();
+        }
+        else
+        {
+            // no digest, or one that does not match: trust the content, as a sender without a store would
+            stored = put(value);
+        }
+        *content = value.to_string();
+        if (contentDigest != NULL)
+        {
+            *contentDigest = stored;
+        }
+        return true;
+    }
+
+    if (contentDigest != NULL)
+    {
+        *contentDigest = key.to_string();
+    }
+    std::unordered_map<std::string, Entry>::iterator stored = genomes.find(key.to_string());
+    if (stored == genomes.end())
+    {
+        return false;
+    }
+    touch(stored->second);
+    *content = stored->second.content;
+    return true;
+}
+
+
+Message GenomeStore::createRequest(const std::string & digest)
+{
+    Message request(GENOME_REQUEST_MESSAGE);
+    request.add("DIGEST", digest);
+    return request;
+}
+
+
+Message GenomeStore::createContent(boost::string_ref digest) const
+{
+    const std::string * content = find(digest);
+    if (content == NULL)
+    {
+        return Message();
+    }
+    Message answer(GENOME_CONTENT_MESSAGE);
+    answer.add("DIGEST", digest).add("CONTENT", *content);
+    return answer;
+}
+
+
+void GenomeStore::store(const std::string & key, boost::string_ref content)
+{
+    std::unordered_map<std::string, Entry>::iterator stored = genomes.find(key);
+    if (stored != genomes.end())
+    {
+        touch(stored->second);
+        return;
+    }
+    unheld.push_front(key);
+    Entry & entry = genomes[key];
+    entry.content = content.to_string();
+    entry.holders = 0;
+    entry.unheldPosition = unheld.begin();
+    shrink();
+}
+
+
+void GenomeStore::touch(Entry & entry)
+{
+    if (entry.holders == 0)
+    {
+        unheld.splice(unheld.begin(), unheld, entry.unheldPosition);
+    }
+}
+
+
+void GenomeStore::shrink()
+{
+    while (unheld.size() > capacity)
+    {
+        const std::string & key = unheld.back();
+        for (std::map<int, std::set<std::string> >::iterator channel = sent.begin(); channel != sent.end(); ++channel)
+        {
+            channel->second.erase(key);
+        }
+        genomes.erase(key);
+        unheld.pop_back();
+    }
+}
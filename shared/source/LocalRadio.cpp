@@ -0,0 +1,214 @@
+#include "LocalRadio.h"
+
+
+static void setVector(double * vector, double x, double y, double z)
+{
+    vector[0] = x;
+    vector[1] = y;
+    vector[2] = z;
+}
+
+
+/********************************************/
+/*************** LOCAL EMITTER **************/
+/********************************************/
+
+LocalEmitter::LocalEmitter(LocalRadioBus & bus, int channel) : bus(bus), channel(channel), range(-1)
+{
+    setVector(position, 0, 0, 0);
+}
+
+
+int LocalEmitter::send(const void * data, int size)
+{
+    bus.send(*this, data, size);
+    return 1;
+}
+
+
+void LocalEmitter::setChannel(int channel)
+{
+    this->channel = channel;
+}
+
+
+int LocalEmitter::getChannel() const
+{
+    return channel;
+}
+
+
+void LocalEmitter::setRange(double range)
+{
+    this->range = range;
+}
+
+
+double LocalEmitter::getRange() const
+{
+    return range;
+}
+
+
+void LocalEmitter::setPosition(double x, double y, double z)
+{
+    setVector(position, x, y, z);
+}
+
+
+const double * LocalEmitter::getPosition() const
+{
+    return position;
+}
+
+
+/********************************************/
+/************** LOCAL RECEIVER **************/
+/********************************************/
+
+LocalReceiver::LocalReceiver(int channel) : channel(channel)
+{
+    setVector(position, 0, 0, 0);
+}
+
+
+const void * LocalReceiver::getData() const
+{
+    if (queue.empty())
+    {
+        return NULL;
+    }
+    return queue.front().data();
+}
+
+
+int LocalReceiver::getDataSize() const
+{
+    if (queue.empty())
+    {
+        return 0;
+    }
+    return (int) queue.front().size();
+}
+
+
+void LocalReceiver::nextPacket()
+{
+    if (!queue.empty())
+    {
+        queue.pop_front();
+    }
+}
+
+
+int LocalReceiver::getQueueLength() const
+{
+    return (int) queue.size();
+}
+
+
+void LocalReceiver::setChannel(int channel)
+{
+    this->channel = channel;
+}
+
+
+int LocalReceiver::getChannel() const
+{
+    return channel;
+}
+
+
+void LocalReceiver::setPosition(double x, double y, double z)
+{
+    setVector(position, x, y, z);
+}
+
+
+const double * LocalReceiver::getPosition() const
+{
+    return position;
+}
+
+
+void LocalReceiver::deliver(const std::string & packet)
+{
+    queue.push_back(packet);
+}
+
+
+/********************************************/
+/***************** RADIO BUS ****************/
+/********************************************/
+
+LocalEmitter * LocalRadioBus::createEmitter(int channel)
+{
+    emitters.push_back(std::unique_ptr<LocalEmitter>(new LocalEmitter(*this, channel)));
+    return emitters.back().get();
+}
+
+
+LocalReceiver * LocalRadioBus::createReceiver(int channel)
+{
+    receivers.push_back(std::unique_ptr<LocalReceiver>(new LocalReceiver(channel)));
+    return receivers.back().get();
+}
+
+
+void LocalRadioBus::send(const LocalEmitter & emitter, const void * data, int size)
+{
+    Packet packet;
+    packet.channel = emitter.getChannel();
+    packet.range = emitter.getRange();
+    setVector(packet.position, emitter.getPosition()[0], emitter.getPosition()[1], emitter.getPosition()[2]);
+    packet.data.assign((const char *) data, size);
+    inFlight.push_back(packet);
+    sentPackets++;
+}
+
+
+void LocalRadioBus::step()
+{
+    std::vector<Packet> packets;
+    packets.swap(inFlight);
+
+    for (size_t i = 0; i < packets.size(); i++)
+    {
+        const Packet & packet = packets[i];
+        for (size_t j = 0; j < receivers.size(); j++)
+        {
+            LocalReceiver & receiver = *receivers[j];
+            if (packet.channel != CHANNEL_BROADCAST && receiver.getChannel() != CHANNEL_BROADCAST && packet.channel != receiver.getChannel())
+            {
+                continue;
+            }
+            if (packet.range >= 0)
+            {
+                double squaredDistance = 0;
+                for (int k = 0; k < 3; k++)
+                {
+                    double difference = packet.position[k] - receiver.getPosition()[k];
+                    squaredDistance += difference * difference;
+                }
+                if (squaredDistance > packet.range * packet.range)
+                {
+                    continue;
+                }
+            }
+            receiver.deliver(packet.data);
+            deliveredPackets++;
+        }
+    }
+}
+
+
+unsigned long LocalRadioBus::getSentPackets() const
+{
+    return sentPackets;
+}
+
+
+unsigned long LocalRadioBus::getDeliveredPackets() const
+{
+    return deliveredPackets;
+}
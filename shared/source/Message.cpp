@@ -0,0 +1,290 @@
+#include "Message.h"
+#include "MessageView.h"
+
+#include <zlib.h>
+
+
+const char Message::MAGIC[4] = { '\x7f', 'T', 'O', 'L' };
+
+static const char * TYPE_TAGS[MESSAGE_TYPES_COUNT] = {
+    "[UNKNOWN_MESSAGE]",
+    "[ENVIRONMENT_OK_MESSAGE]",
+    "[GENOME_TO_CLINIC_MESSAGE]",
+    "[ORGANISM_BUILT_MESSAGE]",
+    "[UPDATE_AVAILABLE_MESSAGE]",
+    "[REBUILD_MESSAGE]",
+    "[DEATH_ANNOUNCEMENT_MESSAGE]",
+    "[ADULT_ANNOUNCEMENT]",
+    "[FERTILE_ANNOUNCEMENT]",
+    "[FITNESS_UPDATE]",
+    "[COUPLE_MESSAGE]",
+    "[GENOME_SPREAD_MESSAGE]",
+    "[TO_RESERVE_MESSAGE]",
+    "[ENERGY_UPDATE]",
+    "[CONNECTORS_PROBLEM_MESSAGE]",
+    "[CYLINDER_PROBLEM_MESSAGE]",
+    "[GENOME_REQUEST_MESSAGE]",
+    "[GENOME_CONTENT_MESSAGE]",
+    "[BATCH_MESSAGE]"
+};
+
+
+static size_t compressionThresholds[MESSAGE_TYPES_COUNT] = {
+    0,                                          // UNKNOWN_MESSAGE
+    0,                                          // ENVIRONMENT_OK_MESSAGE
+    Message::DEFAULT_COMPRESSION_THRESHOLD,     // GENOME_TO_CLINIC_MESSAGE
+    Message::DEFAULT_COMPRESSION_THRESHOLD,     // ORGANISM_BUILT_MESSAGE
+    0,                                          // UPDATE_AVAILABLE_MESSAGE
+    Message::DEFAULT_COMPRESSION_THRESHOLD,     // REBUILD_MESSAGE
+    0,                                          // DEATH_ANNOUNCEMENT_MESSAGE
+    0,                                          // ADULT_ANNOUNCEMENT
+    0,                                          // FERTILE_ANNOUNCEMENT
+    0,                                          // FITNESS_UPDATE
+    Message::DEFAULT_COMPRESSION_THRESHOLD,     // COUPLE_MESSAGE
+    Message::DEFAULT_COMPRESSION_THRESHOLD,     // GENOME_SPREAD_MESSAGE
+    0,                                          // TO_RESERVE_MESSAGE
+    0,                                          // ENERGY_UPDATE
+    0,                                          // CONNECTORS_PROBLEM_MESSAGE
+    0,                                          // CYLINDER_PROBLEM_MESSAGE
+    0,                                          // GENOME_REQUEST_MESSAGE
+    Message::DEFAULT_COMPRESSION_THRESHOLD,     // GENOME_CONTENT_MESSAGE
+    0                                           // BATCH_MESSAGE, records are compressed on their own
+};
+
+
+/********************************************/
+/************** BYTE HELPERS ****************/
+/********************************************/
+
+static void putUInt16(std::string & out, uint16_t value)
+{
+    out.push_back((char)(value & 0xff));
+    out.push_back((char)((value >> 8) & 0xff));
+}
+
+
+static void putUInt32(std::string & out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        out.push_back((char)((value >> (8 * i)) & 0xff));
+    }
+}
+
+
+/********************************************/
+/***************** MESSAGE ******************/
+/********************************************/
+
+Message::Message(MessageType type) : type(type), legacy(false)
+{
+    //nix
+}
+
+
+Message::Message(const MessageView & view) : type(view.getType()), legacy(view.isLegacy())
+{
+    if (legacy)
+    {
+        payload = view.getText().to_string();
+        return;
+    }
+
+    size_t payloadSize = 0;
+    for (size_t i = 0; i < view.getFieldsCount(); i++)
+    {
+        payloadSize += view.getFieldName(i).size() + view.getFieldValue(i).size();
+    }
+    fields.reserve(view.getFieldsCount());
+    payload.reserve(payloadSize);
+    for (size_t i = 0; i < view.getFieldsCount(); i++)
+    {
+        add(view.getFieldName(i), view.getFieldValue(i));
+    }
+}
+
+
+Message & Message::add(boost::string_ref field, boost::string_ref value)
+{
+    Field entry;
+    entry.offset = (uint32_t)payload.size();
+    entry.nameLength = (uint16_t)field.size();
+    entry.valueLength = (uint32_t)value.size();
+    fields.push_back(entry);
+
+    payload.append(field.data(), field.size());
+    payload.append(value.data(), value.size());
+    return *this;
+}
+
+
+bool Message::findField(boost::string_ref field, size_t * valueStart, size_t * valueLength) const
+{
+    if (legacy)
+    {
+        std::string start = "*" + field.to_string();
+        std::string end = field.to_string() + "*";
+        size_t startPosition = payload.find(start);
+        if (startPosition == std::string::npos)
+        {
+            return false;
+        }
+        startPosition += start.length();
+        size_t endPosition = payload.find(end, startPosition);
+        if (endPosition == std::string::npos)
+        {
+            return false;
+        }
+        *valueStart = startPosition;
+        *valueLength = endPosition - startPosition;
+        return true;
+    }
+
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        const Field & entry = fields[i];
+        if (entry.nameLength == field.size() && payload.compare(entry.offset, entry.nameLength, field.data(), field.size()) == 0)
+        {
+            *valueStart = entry.offset + entry.nameLength;
+            *valueLength = entry.valueLength;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+std::string Message::get(boost::string_ref field) const
+{
+    return getView(field).to_string();
+}
+
+
+boost::string_ref Message::getView(boost::string_ref field) const
+{
+    size_t start, length;
+    if (!findField(field, &start, &length))
+    {
+        return boost::string_ref();
+    }
+    return boost::string_ref(payload.data() + start, length);
+}
+
+
+bool Message::has(boost::string_ref field) const
+{
+    size_t start, length;
+    return findField(field, &start, &length);
+}
+
+
+MessageType Message::getType() const
+{
+    return type;
+}
+
+
+bool Message::isLegacy() const
+{
+    return legacy;
+}
+
+
+void Message::setCompressionThreshold(MessageType type, size_t threshold)
+{
+    if (type < MESSAGE_TYPES_COUNT)
+    {
+        compressionThresholds[type] = threshold;
+    }
+}
+
+
+size_t Message::getCompressionThreshold(MessageType type)
+{
+    if (type >= MESSAGE_TYPES_COUNT)
+    {
+        return 0;
+    }
+    return compressionThresholds[type];
+}
+
+
+const char * Message::getTypeTag(MessageType type)
+{
+    if (type >= MESSAGE_TYPES_COUNT)
+    {
+        return TYPE_TAGS[UNKNOWN_MESSAGE];
+    }
+    return TYPE_TAGS[type];
+}
+
+
+std::string Message::encode() const
+{
+    std::string body;
+    body.reserve(fields.size() * WIRE_FIELD_SIZE + payload.size());
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        putUInt16(body, fields[i].nameLength);
+        putUInt16(body, 0);
+        putUInt32(body, fields[i].offset);
+        putUInt32(body, fields[i].valueLength);
+    }
+    body.append(payload);
+
+    uint8_t flags = 0;
+    size_t threshold = getCompressionThreshold(type);
+    if (threshold > 0 && body.size() >= threshold)
+    {
+        uLongf compressedSize = compressBound((uLong)body.size());
+        std::string compressed(4 + compressedSize, '\0');
+        if (compress2((Bytef *)&compressed[4], &compressedSize, (const Bytef *)body.data(), (uLong)body.size(), Z_BEST_SPEED) == Z_OK
+            && 4 + compressedSize < body.size())
+        {
+            compressed.resize(4 + compressedSize);
+            for (int i = 0; i < 4; i++)
+            {
+                compressed[i] = (char)((body.size() >> (8 * i)) & 0xff);
+            }
+            body.swap(compressed);
+            flags |= FLAG_COMPRESSED;
+        }
+    }
+
+    std::string out;
+    out.reserve(WIRE_HEADER_SIZE + body.size());
+
+    out.append(MAGIC, sizeof(MAGIC));
+    out.push_back((char)VERSION);
+    out.push_back((char)flags);
+    putUInt16(out, type);
+    putUInt16(out, (uint16_t)fields.size());
+    putUInt16(out, 0);
+    putUInt32(out, (uint32_t)(flags & FLAG_COMPRESSED ? body.size() : payload.size()));
+
+    out.append(body);
+    return out;
+}
+
+
+std::string Message::toString() const
+{
+    if (legacy)
+    {
+        return payload;
+    }
+
+    std::string text = getTypeTag(type);
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        std::string name = payload.substr(fields[i].offset, fields[i].nameLength);
+        text += "*" + name + payload.substr(fields[i].offset + fields[i].nameLength, fields[i].valueLength) + name + "*";
+    }
+    return text;
+}
+
+
+Message Message::decode(const void * data, size_t size)
+{
+    return Message(MessageView(data, size));
+}
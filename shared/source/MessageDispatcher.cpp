@@ -0,0 +1,98 @@
+#include "MessageDispatcher.h"
+
+#include <chrono>
+#include <sstream>
+
+
+MessageDispatcher::MessageDispatcher()
+{
+    resetStatistics();
+}
+
+
+void MessageDispatcher::registerHandler(MessageType type, Handler handler)
+{
+    handlers[type] = handler;
+}
+
+
+void MessageDispatcher::unregisterHandler(MessageType type)
+{
+    handlers[type] = Handler();
+}
+
+
+bool MessageDispatcher::hasHandler(MessageType type) const
+{
+    return (bool) handlers[type];
+}
+
+
+bool MessageDispatcher::dispatch(const MessageView & message)
+{
+    MessageType type = message.getType();
+    counts[type]++;
+
+    if (type == BATCH_MESSAGE)
+    {
+        for (size_t i = 0; i < message.getFieldsCount(); i++)
+        {
+            boost::string_ref record = message.getFieldValue(i);
+            MessageView view(record.data(), record.size());
+            if (view.getType() == BATCH_MESSAGE)
+            {
+                // MessageHandler never nests batches, and following nested ones would let a packet recurse without bound
+                counts[BATCH_MESSAGE]++;
+                continue;
+            }
+            dispatch(view);
+        }
+        return true;
+    }
+
+    if (!handlers[type])
+    {
+        return true;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool done = handlers[type](message);
+    handlingTimes[type] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return done;
+}
+
+
+unsigned long MessageDispatcher::getCount(MessageType type) const
+{
+    return counts[type];
+}
+
+
+double MessageDispatcher::getHandlingTime(MessageType type) const
+{
+    return handlingTimes[type];
+}
+
+
+std::string MessageDispatcher::getStatistics() const
+{
+    std::stringstream statistics;
+    for (int i = 0; i < MESSAGE_TYPES_COUNT; i++)
+    {
+        if (counts[i] > 0)
+        {
+            statistics << Message::getTypeTag((MessageType) i) << " " << counts[i] << " " << handlingTimes[i] << "s" << std::endl;
+        }
+    }
+    return statistics.str();
+}
+
+
+void MessageDispatcher::resetStatistics()
+{
+    for (int i = 0; i < MESSAGE_TYPES_COUNT; i++)
+    {
+        counts[i] = 0;
+        handlingTimes[i] = 0;
+    }
+}
@@ -0,0 +1,252 @@
+#include "MessageView.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+
+static uint16_t getUInt16(const char * data)
+{
+    const unsigned char * bytes = (const unsigned char *) data;
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+
+static uint32_t getUInt32(const char * data)
+{
+    const unsigned char * bytes = (const unsigned char *) data;
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+
+/**
+ * Copies a short numeric value into a terminated buffer, since views are not terminated.
+ */
+static void toNumberBuffer(boost::string_ref value, char * buffer, size_t bufferSize)
+{
+    size_t length = std::min(value.size(), bufferSize - 1);
+    std::memcpy(buffer, value.data(), length);
+    buffer[length] = '\0';
+}
+
+
+MessageView::MessageView(const void * data, size_t size) : type(UNKNOWN_MESSAGE), legacy(false)
+{
+    const char * bytes = (const char *) data;
+    if (bytes == NULL || size == 0)
+    {
+        return;
+    }
+
+    if (size >= sizeof(Message::MAGIC) && std::memcmp(bytes, Message::MAGIC, sizeof(Message::MAGIC)) == 0)
+    {
+        if (!indexBinary(bytes, size))
+        {
+            type = UNKNOWN_MESSAGE;
+            fields.clear();
+            inflated.reset();
+        }
+        return;
+    }
+
+    // text messages are sent together with their terminating character
+    legacy = true;
+    text = boost::string_ref(bytes, strnlen(bytes, size));
+    for (int i = 1; i < MESSAGE_TYPES_COUNT; i++)
+    {
+        if (text.starts_with(Message::getTypeTag((MessageType) i)))
+        {
+            type = (MessageType) i;
+            return;
+        }
+    }
+}
+
+
+bool MessageView::indexBinary(const char * data, size_t size)
+{
+    if (size < Message::WIRE_HEADER_SIZE || (uint8_t)data[4] != Message::VERSION)
+    {
+        return false;
+    }
+
+    uint8_t flags = (uint8_t)data[5];
+    uint16_t messageType = getUInt16(data + 6);
+    size_t fieldsCount = getUInt16(data + 8);
+    size_t payloadSize = getUInt32(data + 12);
+    if (messageType >= MESSAGE_TYPES_COUNT)
+    {
+        return false;
+    }
+
+    if (flags & Message::FLAG_COMPRESSED)
+    {
+        if (payloadSize < 4 || Message::WIRE_HEADER_SIZE + payloadSize != size)
+        {
+            return false;
+        }
+        const char * block = data + Message::WIRE_HEADER_SIZE;
+        uLongf inflatedSize = getUInt32(block);
+        if (inflatedSize < fieldsCount * Message::WIRE_FIELD_SIZE || inflatedSize > Message::MAXIMUM_INFLATED_SIZE)
+        {
+            return false;
+        }
+        inflated = std::make_shared<std::vector<char> >(inflatedSize);
+        uLongf expectedSize = inflatedSize;
+        if (uncompress((Bytef *)inflated->data(), &inflatedSize, (const Bytef *)block + 4, (uLong)(payloadSize - 4)) != Z_OK
+            || inflatedSize != expectedSize)
+        {
+            return false;
+        }
+        type = (MessageType) messageType;
+        return indexFields(inflated->data(), fieldsCount, inflatedSize - fieldsCount * Message::WIRE_FIELD_SIZE);
+    }
+
+    if (Message::WIRE_HEADER_SIZE + fieldsCount * Message::WIRE_FIELD_SIZE + payloadSize != size)
+    {
+        return false;
+    }
+    type = (MessageType) messageType;
+    return indexFields(data + Message::WIRE_HEADER_SIZE, fieldsCount, payloadSize);
+}
+
+
+bool MessageView::indexFields(const char * table, size_t fieldsCount, size_t payloadSize)
+{
+    const char * payload = table + fieldsCount * Message::WIRE_FIELD_SIZE;
+    fields.reserve(fieldsCount);
+    for (size_t i = 0; i < fieldsCount; i++)
+    {
+        const char * entry = table + i * Message::WIRE_FIELD_SIZE;
+        size_t nameLength = getUInt16(entry);
+        size_t offset = getUInt32(entry + 4);
+        size_t valueLength = getUInt32(entry + 8);
+        if (offset + nameLength + valueLength > payloadSize)
+        {
+            return false;
+        }
+
+        Field field;
+        field.name = boost::string_ref(payload + offset, nameLength);
+        field.value = boost::string_ref(payload + offset + nameLength, valueLength);
+        fields.push_back(field);
+    }
+    return true;
+}
+
+
+bool MessageView::findField(boost::string_ref field, boost::string_ref * value) const
+{
+    if (legacy)
+    {
+        std::string start = "*" + field.to_string();
+        std::string end = field.to_string() + "*";
+        size_t startPosition = text.find(start);
+        if (startPosition == boost::string_ref::npos)
+        {
+            return false;
+        }
+        startPosition += start.length();
+        size_t endPosition = text.substr(startPosition).find(end);
+        if (endPosition == boost::string_ref::npos)
+        {
+            return false;
+        }
+        *value = text.substr(startPosition, endPosition);
+        return true;
+    }
+
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        if (fields[i].name == field)
+        {
+            *value = fields[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+boost::string_ref MessageView::get(boost::string_ref field) const
+{
+    boost::string_ref value;
+    findField(field, &value);
+    return value;
+}
+
+
+bool MessageView::has(boost::string_ref field) const
+{
+    boost::string_ref value;
+    return findField(field, &value);
+}
+
+
+long MessageView::getLong(boost::string_ref field) const
+{
+    char buffer[32];
+    toNumberBuffer(get(field), buffer, sizeof(buffer));
+    return std::atol(buffer);
+}
+
+
+double MessageView::getDouble(boost::string_ref field) const
+{
+    char buffer[64];
+    toNumberBuffer(get(field), buffer, sizeof(buffer));
+    return std::atof(buffer);
+}
+
+
+MessageType MessageView::getType() const
+{
+    return type;
+}
+
+
+bool MessageView::isLegacy() const
+{
+    return legacy;
+}
+
+
+size_t MessageView::getFieldsCount() const
+{
+    return fields.size();
+}
+
+
+boost::string_ref MessageView::getFieldName(size_t index) const
+{
+    return fields[index].name;
+}
+
+
+boost::string_ref MessageView::getFieldValue(size_t index) const
+{
+    return fields[index].value;
+}
+
+
+boost::string_ref MessageView::getText() const
+{
+    return text;
+}
+
+
+std::string MessageView::toString() const
+{
+    if (legacy)
+    {
+        return text.to_string();
+    }
+
+    std::string result = Message::getTypeTag(type);
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        std::string name = fields[i].name.to_string();
+        result += "*" + name + fields[i].value.to_string() + name + "*";
+    }
+    return result;
+}
@@ -1,4 +1,5 @@
 #include "Organism.h"
+#include "GenomeStore.h"
 #include "Random.h"
 
 /**
@@ -10,6 +11,8 @@ Organism::Organism(const Organism &other)
     id = other.id;
     genome = other.genome;
     mindGenome = other.mindGenome;
+    genomeDigest = other.genomeDigest;
+    mindDigest = other.mindDigest;
     fitness = other.fitness;
     parents = other.parents;
     offspring = other.offspring;
@@ -36,7 +39,8 @@ robots(), organismCentre(organismCentre), buildPlan(plan)
 }
 
 Organism::Organism(std::string genome, std::string mindGenome, id_t organismID, double fitness, unsigned int size, unsigned int offspring, std::vector<id_t> parents, State state, bool fertile) :
-    fitness(fitness), id(organismID), genome(genome), mindGenome(mindGenome), size(size), offspring(offspring), parents(parents), state(state), fertile(fertile)
+    fitness(fitness), id(organismID), genome(std::make_shared<const std::string>(genome)), mindGenome(std::make_shared<const std::string>(mindGenome)),
+    size(size), offspring(offspring), parents(std::make_shared<const std::vector<id_t> >(parents)), state(state), fertile(fertile)
 {
 }
 
@@ -52,41 +56,67 @@ Organism::~Organism()
 
 void Organism::setGenome(std::string g)
 {
-    genome = g;
+    genome = std::make_shared<const std::string>(g);
+    genomeDigest.reset();
 }
 
 
-std::string Organism::getGenome()
+const std::string & Organism::getGenome() const
 {
-    return genome;
+    return *genome;
 }
 
 void Organism::setMind(std::string m)
 {
-    mindGenome = m;
+    mindGenome = std::make_shared<const std::string>(m);
+    mindDigest.reset();
 }
 
 
-std::string Organism::getMind()
+const std::string & Organism::getMind() const
 {
-    return mindGenome;
+    return *mindGenome;
+}
+
+void Organism::setDigests(std::string g, std::string m)
+{
+    genomeDigest = std::make_shared<const std::string>(g);
+    mindDigest = std::make_shared<const std::string>(m);
+}
+
+const std::string & Organism::getGenomeDigest() const
+{
+    if (!genomeDigest)
+    {
+        genomeDigest = std::make_shared<const std::string>(GenomeStore::digest(*genome));
+    }
+    return *genomeDigest;
+}
+
+const std::string & Organism::getMindDigest() const
+{
+    if (!mindDigest)
+    {
+        mindDigest = std::make_shared<const std::string>(GenomeStore::digest(*mindGenome));
+    }
+    return *mindDigest;
 }
 
 void Organism::setFitness(double f) {
     fitness = f;
 }
 
-double Organism::getFitness() {
+double Organism::getFitness() const {
     return fitness;
 }
 
 
-id_t Organism::getId()
+id_t Organism::getId() const
 {
     return id;
 }
 
-std::string Organism::getName()
+std::string Organism::getName() const
 {
     return ORGANISM_BASE_NAME + std::to_string(id);
 }
@@ -95,7 +125,7 @@ void Organism::setState(State s) {
     state = s;
 }
 
-Organism::State Organism::getState() {
+Organism::State Organism::getState() const {
     return state;
 }
 
@@ -103,7 +133,7 @@ void Organism::setFertile(bool f) {
     fertile = f;
 }
 
-bool Organism::getFertile() {
+bool Organism::getFertile() const {
     return fertile;
 }
 
@@ -111,7 +141,7 @@ void Organism::setSize(unsigned int s) {
     size = s;
 }
 
-unsigned int Organism::getSize() {
+unsigned int Organism::getSize() const {
     return size;
 }
 
@@ -119,16 +149,16 @@ void Organism::setOffspring(unsigned int o) {
     offspring = o;
 }
 
-unsigned int Organism::getOffspring() {
+unsigned int Organism::getOffspring() const {
     return offspring;
 }
 
 void Organism::setParents(std::vector<id_t> p) {
-    parents = p;
+    parents = std::make_shared<const std::vector<id_t> >(p);
 }
 
-std::vector<id_t> Organism::getParents() {
-    return parents;
+const std::vector<id_t> & Organism::getParents() const {
+    return *parents;
 }
 
 size_t BuildableOrganism::getSize()
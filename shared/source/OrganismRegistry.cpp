@@ -0,0 +1,245 @@
+#include "OrganismRegistry.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+/********************************************/
+/**************** STATISTICS ****************/
+/********************************************/
+
+double OrganismRegistry::Statistics::getFitnessMean() const
+{
+    return adults > 0 ? fitnessSum / adults : 0;
+}
+
+
+double OrganismRegistry::Statistics::getFitnessVariance() const
+{
+    if (adults == 0)
+    {
+        return 0;
+    }
+    double mean = getFitnessMean();
+    return std::max(0.0, fitnessSquaresSum / adults - mean * mean);
+}
+
+
+/********************************************/
+/************ ORGANISM REGISTRY *************/
+/********************************************/
+
+void OrganismRegistry::setChangeListener(const ChangeListener & listener)
+{
+    changeListener = listener;
+}
+
+
+void OrganismRegistry::add(const Organism & organism)
+{
+    organisms.push_back(organism);
+    positions[organisms.back().getId()] = organisms.size() - 1;
+    count(organism, 1);
+    if (changeListener)
+    {
+        changeListener(ADDED, organisms.back());
+    }
+}
+
+
+void OrganismRegistry::remove(size_t index)
+{
+    if (changeListener)
+    {
+        changeListener(REMOVED, organisms[index]);
+    }
+    count(organisms[index], -1);
+    positions.erase(organisms[index].getId());
+    organisms.erase(organisms.begin() + index);
+    for (size_t i = index; i < organisms.size(); i++)
+    {
+        positions[organisms[i].getId()] = i;
+    }
+}
+
+
+void OrganismRegistry::archive(size_t index)
+{
+    Organism & organism = organisms[index];
+    const std::vector<id_t> & parents = organism.getParents();
+
+    ArchivedOrganism entry;
+    entry.id = organism.getId();
+    entry.parent1 = parents.size() > 0 ? parents[0] : 0;
+    entry.parent2 = parents.size() > 1 ? parents[1] : 0;
+    entry.size = organism.getSize();
+    entry.offspring = organism.getOffspring();
+    entry.fitness = organism.getFitness();
+    archivedPositions[entry.id] = archived.size();
+    archived.push_back(entry);
+
+    remove(index);
+}
+
+
+void OrganismRegistry::archiveAll()
+{
+    while (!organisms.empty())
+    {
+        archive(organisms.size() - 1);
+    }
+}
+
+
+OrganismRegistry::ArchivedOrganism * OrganismRegistry::findArchived(id_t organismId)
+{
+    std::unordered_map<id_t, size_t>::const_iterator position = archivedPositions.find(organismId);
+    if (position == archivedPositions.end())
+    {
+        return NULL;
+    }
+    return &archived[position->second];
+}
+
+
+size_t OrganismRegistry::getArchivedCount() const
+{
+    return archived.size();
+}
+
+
+int OrganismRegistry::find(id_t organismId) const
+{
+    std::unordered_map<id_t, size_t>::const_iterator position = positions.find(organismId);
+    if (position == positions.end())
+    {
+        return -1;
+    }
+    return (int) position->second;
+}
+
+
+bool OrganismRegistry::contains(id_t organismId) const
+{
+    return positions.count(organismId) > 0;
+}
+
+
+void OrganismRegistry::setState(size_t index, Organism::State state)
+{
+    if (organisms[index].getState() == state)
+    {
+        return;
+    }
+    count(organisms[index], -1);
+    organisms[index].setState(state);
+    count(organisms[index], 1);
+    if (changeListener)
+    {
+        changeListener(STATE_CHANGED, organisms[index]);
+    }
+}
+
+
+void OrganismRegistry::setFertile(size_t index, bool fertile)
+{
+    count(organisms[index], -1);
+    organisms[index].setFertile(fertile);
+    count(organisms[index], 1);
+}
+
+
+void OrganismRegistry::setFitness(size_t index, double fitness)
+{
+    count(organisms[index], -1);
+    organisms[index].setFitness(fitness);
+    count(organisms[index], 1);
+}
+
+
+const OrganismRegistry::Statistics & OrganismRegistry::getStatistics() const
+{
+    return statistics;
+}
+
+
+double OrganismRegistry::getMaxFitness() const
+{
+    return adultsFitness.empty() ? 0 : *adultsFitness.rbegin();
+}
+
+
+void OrganismRegistry::count(const Organism & organism, int sign)
+{
+    if (organism.getState() == Organism::INFANT)
+    {
+        statistics.infants += sign;
+    }
+    else if (organism.getState() == Organism::ADULT)
+    {
+        // a NaN or infinite fitness would stay in the sums and break the ordering of adultsFitness
+        double fitness = std::isfinite(organism.getFitness()) ? organism.getFitness() : 0;
+        statistics.adults += sign;
+        statistics.fitnessSum += sign * fitness;
+        statistics.fitnessSquaresSum += sign * fitness * fitness;
+        if (sign > 0)
+        {
+            adultsFitness.insert(fitness);
+        }
+        else
+        {
+            std::multiset<double>::iterator counted = adultsFitness.find(fitness);
+            if (counted != adultsFitness.end())
+            {
+                adultsFitness.erase(counted);
+            }
+        }
+        if (statistics.adults == 0)
+        {
+            // do not let rounding errors accumulate
+            statistics.fitnessSum = 0;
+            statistics.fitnessSquaresSum = 0;
+        }
+    }
+    if (organism.getFertile())
+    {
+        statistics.fertile += sign;
+    }
+    statistics.modules += sign * (long) organism.getSize();
+}
+
+
+Organism & OrganismRegistry::operator[](size_t index)
+{
+    return organisms[index];
+}
+
+
+size_t OrganismRegistry::size() const
+{
+    return organisms.size();
+}
+
+
+bool OrganismRegistry::empty() const
+{
+    return organisms.empty();
+}
+
+
+void OrganismRegistry::clear()
+{
+    if (changeListener)
+    {
+        for (size_t i = organisms.size(); i > 0; i--)
+        {
+            changeListener(REMOVED, organisms[i - 1]);
+        }
+    }
+    organisms.clear();
+    positions.clear();
+    archived.clear();
+    archivedPositions.clear();
+    statistics = Statistics();
+    adultsFitness.clear();
+}
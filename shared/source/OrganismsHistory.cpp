@@ -0,0 +1,110 @@
+#include "OrganismsHistory.h"
+
+#include <sstream>
+
+
+static const char * CHANGE_NAMES[] = { "ADD", "STATE", "REMOVE" };
+
+const char * OrganismsHistory::HEADER = "#time change id state\n";
+
+
+std::string OrganismsHistory::format(double time, OrganismRegistry::Change change, id_t id, int state)
+{
+    return std::to_string(time) + " " + CHANGE_NAMES[change] + " " + std::to_string(id) + " " + std::to_string(state) + "\n";
+}
+
+
+std::vector<OrganismsHistory::Change> OrganismsHistory::read(std::istream & stream)
+{
+    std::vector<Change> changes;
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        
+        std::istringstream fields(line);
+        std::string name;
+        Change change;
+        if (!(fields >> change.time >> name >> change.id >> change.state))
+        {
+            continue;
+        }
+        
+        bool known = false;
+        for (int i = OrganismRegistry::ADDED; i <= OrganismRegistry::REMOVED; i++)
+        {
+            if (name == CHANGE_NAMES[i])
+            {
+                change.change = (OrganismRegistry::Change) i;
+                known = true;
+            }
+        }
+        if (known)
+        {
+            changes.push_back(change);
+        }
+    }
+    return changes;
+}
+
+
+void OrganismsHistory::apply(const Change & change)
+{
+    if (change.change == OrganismRegistry::ADDED)
+    {
+        Entry entry;
+        entry.id = change.id;
+        entry.state = change.state;
+        organisms.push_back(entry);
+        return;
+    }
+    
+    // the live organisms are few, compared to all the organisms born during an experiment
+    for (size_t i = 0; i < organisms.size(); i++)
+    {
+        if (organisms[i].id == change.id)
+        {
+            if (change.change == OrganismRegistry::REMOVED)
+            {
+                organisms.erase(organisms.begin() + i);
+            }
+            else
+            {
+                organisms[i].state = change.state;
+            }
+            return;
+        }
+    }
+}
+
+
+size_t OrganismsHistory::applyUntil(const std::vector<Change> & changes, double time)
+{
+    size_t first = applied;
+    while (applied < changes.size() && changes[applied].time <= time)
+    {
+        apply(changes[applied]);
+        applied++;
+    }
+    return applied - first;
+}
+
+
+const std::vector<OrganismsHistory::Entry> & OrganismsHistory::getOrganisms() const
+{
+    return organisms;
+}
+
+
+std::string OrganismsHistory::toString() const
+{
+    std::string text;
+    for (size_t i = 0; i < organisms.size(); i++)
+    {
+        text += std::to_string(i) + " " + std::to_string(organisms[i].id) + " " + std::to_string(organisms[i].state) + "\n";
+    }
+    return text;
+}
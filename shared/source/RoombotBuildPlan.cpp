@@ -93,18 +93,15 @@ bool RoombotBuildPlan::getConnector(size_t index, size_t connectorIndex) const
 void RoombotBuildPlan::add(int x, int z, bool isHorizontal)
 {
     positions.push_back(RelativePosition(x,z,isHorizontal));
+    cells[cellKey(positions.back().getX(), positions.back().getZ())]++;
+    cells[cellKey(positions.back().getX2(), positions.back().getZ2())]++;
 }
 
 
 int RoombotBuildPlan::numberOfNeighbours(const RelativePosition& position) const
 {
-    int result = 0;
-    
-    for(size_t i=0; i<positions.size(); i++){
-        result+= positions.at(i).nrOfAdjacentPositions(position);
-    }
-    
-    return result;
+    //Every module half adjacent to one of the two halves of position
+    return numberOfNeighbours(position.getX(), position.getZ()) + numberOfNeighbours(position.getX2(), position.getZ2());
 }
 
 
@@ -116,13 +113,7 @@ int RoombotBuildPlan::numberOfNeighbours(int x, int z, bool isHorizontal) const
 
 int RoombotBuildPlan::numberOfNeighbours(int x, int z) const
 {
-    int result = 0;
-    
-    for(size_t i=0; i<positions.size(); i++){
-        result+= positions.at(i).nrOfAdjacentPositions(x, z);
-    }
-    
-    return result;
+    return modulesOn(x-1, z) + modulesOn(x+1, z) + modulesOn(x, z-1) + modulesOn(x, z+1);
 }
 
 
@@ -204,12 +195,31 @@ RelativePosition RoombotBuildPlan::getMinimalPosition() const
 
 bool RoombotBuildPlan::occupied(int x, int z) const
 {
+    return modulesOn(x, z) > 0;
+}
+
+
+long long RoombotBuildPlan::cellKey(int x, int z)
+{
+    return ((long long)x << 32) | (unsigned int)z;
+}
+
+
+int RoombotBuildPlan::modulesOn(int x, int z) const
+{
+    std::unordered_map<long long, int>::const_iterator cell = cells.find(cellKey(x, z));
+    if(cell == cells.end()) return 0;
+    return cell->second;
+}
+
+
+void RoombotBuildPlan::indexCells()
+{
+    cells.clear();
     for(size_t i=0; i<positions.size(); i++){
-        if(positions[i].getX() == x && positions[i].getZ() == z) return true;
-        if(positions[i].getX2() == x && positions[i].getZ2() == z) return true;
+        cells[cellKey(positions[i].getX(), positions[i].getZ())]++;
+        cells[cellKey(positions[i].getX2(), positions[i].getZ2())]++;
     }
-    
-    return false;
 }
 
 
@@ -263,6 +273,7 @@ void RoombotBuildPlan::shift(int x, int z)
         positions.at(i).x += x;
         positions.at(i).z += z;
     }
+    indexCells();
 }
 
 
@@ -274,6 +285,7 @@ void RoombotBuildPlan::flipHorizontally()
             positions.at(i).x += 1;
         }
     }
+    indexCells();
 }
 
 
@@ -285,6 +297,7 @@ void RoombotBuildPlan::flipVertically()
             positions.at(i).z += 1;
         }
     }
+    indexCells();
 }
 
 
@@ -297,6 +310,7 @@ void RoombotBuildPlan::turnAndMirror()
         positions.at(i).z = temp;
         positions.at(i).isHorizontal = !positions.at(i).isHorizontal;
     }
+    indexCells();
 }
 
 
@@ -0,0 +1,100 @@
+#include "WorkerPool.h"
+
+
+WorkerPool::WorkerPool(unsigned int threadsCount) : task(NULL), count(0), next(0), finished(0), stopping(false)
+{
+    for (unsigned int i = 0; i < threadsCount; i++)
+    {
+        threads.push_back(std::thread(&WorkerPool::work, this));
+    }
+}
+
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+}
+
+
+void WorkerPool::run(size_t tasksCount, const std::function<void (size_t)> & newTask)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    task = &newTask;
+    count = tasksCount;
+    next = 0;
+    finished = 0;
+    error = std::exception_ptr();
+    wakeUp.notify_all();
+
+    runTasks(lock);
+    done.wait(lock, [this] { return finished == count; });
+
+    task = NULL;
+    count = 0;
+    next = 0;
+    if (error)
+    {
+        std::exception_ptr thrown = error;
+        error = std::exception_ptr();
+        std::rethrow_exception(thrown);
+    }
+}
+
+
+size_t WorkerPool::getThreadsCount() const
+{
+    return threads.size();
+}
+
+
+void WorkerPool::work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wakeUp.wait(lock, [this] { return stopping || next < count; });
+        if (stopping)
+        {
+            return;
+        }
+        runTasks(lock);
+    }
+}
+
+
+void WorkerPool::runTasks(std::unique_lock<std::mutex> & lock)
+{
+    while (next < count)
+    {
+        size_t index = next++;
+        const std::function<void (size_t)> & current = *task;
+        lock.unlock();
+        std::exception_ptr thrown;
+        try
+        {
+            current(index);
+        }
+        catch (...)
+        {
+            thrown = std::current_exception();
+        }
+        lock.lock();
+
+        if (thrown && !error)
+        {
+            error = thrown;
+        }
+        if (++finished == count)
+        {
+            done.notify_all();
+        }
+    }
+}